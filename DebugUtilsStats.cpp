@@ -0,0 +1,18 @@
+﻿#include "DebugUtilsStats.h"
+
+#if DEBUGUTILS_TRACE
+
+UE_TRACE_CHANNEL_DEFINE(DebugUtilsChannel);
+
+DEFINE_STAT(STAT_DebugUtils_ParsePath);
+DEFINE_STAT(STAT_DebugUtils_ResolvePath);
+DEFINE_STAT(STAT_DebugUtils_GeneratePath);
+DEFINE_STAT(STAT_DebugUtils_CaptureStack);
+DEFINE_STAT(STAT_DebugUtils_Symbolize);
+DEFINE_STAT(STAT_DebugUtils_FormatRepr);
+DEFINE_STAT(STAT_DebugUtils_SymbolCacheHits);
+DEFINE_STAT(STAT_DebugUtils_SymbolCacheMisses);
+DEFINE_STAT(STAT_DebugUtils_PathIndexTableBuilds);
+DEFINE_STAT(STAT_DebugUtils_ReprBytes);
+
+#endif
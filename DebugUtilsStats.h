@@ -0,0 +1,49 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * Insights trace scopes and STAT counters for the DebugUtils hot paths.
+ * Scopes are emitted on the "DebugUtils" trace channel (enable with -trace=cpu,DebugUtils) and counted in
+ * "stat DebugUtils". Define DEBUGUTILS_TRACE to 0 to compile all of it out.
+ */
+#ifndef DEBUGUTILS_TRACE
+#define DEBUGUTILS_TRACE !UE_BUILD_SHIPPING
+#endif
+
+#if DEBUGUTILS_TRACE
+
+UE_TRACE_CHANNEL_EXTERN(DebugUtilsChannel, DEBUGUTILS_API);
+
+DECLARE_STATS_GROUP(TEXT("DebugUtils"), STATGROUP_DebugUtils, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Parse Path"), STAT_DebugUtils_ParsePath, STATGROUP_DebugUtils, DEBUGUTILS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Resolve Path"), STAT_DebugUtils_ResolvePath, STATGROUP_DebugUtils, DEBUGUTILS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Generate Path"), STAT_DebugUtils_GeneratePath, STATGROUP_DebugUtils, DEBUGUTILS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Capture Stack"), STAT_DebugUtils_CaptureStack, STATGROUP_DebugUtils, DEBUGUTILS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Symbolize"), STAT_DebugUtils_Symbolize, STATGROUP_DebugUtils, DEBUGUTILS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Format Repr"), STAT_DebugUtils_FormatRepr, STATGROUP_DebugUtils, DEBUGUTILS_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Symbol Cache Hits"), STAT_DebugUtils_SymbolCacheHits, STATGROUP_DebugUtils,
+                                  DEBUGUTILS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Symbol Cache Misses"), STAT_DebugUtils_SymbolCacheMisses, STATGROUP_DebugUtils,
+                                  DEBUGUTILS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Path Index Table Builds"), STAT_DebugUtils_PathIndexTableBuilds,
+                                  STATGROUP_DebugUtils, DEBUGUTILS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Repr Bytes Formatted"), STAT_DebugUtils_ReprBytes, STATGROUP_DebugUtils,
+                                  DEBUGUTILS_API);
+
+/** Times the rest of the enclosing scope under the given STAT_DebugUtils_ cycle stat and the DebugUtils trace channel. */
+#define DEBUGUTILS_SCOPE(StatName) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(#StatName, DebugUtilsChannel); \
+	SCOPE_CYCLE_COUNTER(StatName)
+#define DEBUGUTILS_COUNTER_ADD(StatName, Amount) INC_DWORD_STAT_BY(StatName, Amount)
+
+#else
+
+#define DEBUGUTILS_SCOPE(StatName)
+#define DEBUGUTILS_COUNTER_ADD(StatName, Amount)
+
+#endif
@@ -0,0 +1,134 @@
+﻿#include "FCallSiteProfiler.h"
+#include "FSymbolCache.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include <atomic>
+
+namespace
+{
+	/**
+	 * Only the owning thread inserts, so it can look up without the lock; inserting and merging take the lock.
+	 * Counters are heap-allocated so they do not move when the map grows.
+	 */
+	struct FThreadCallSiteTable
+	{
+		FCriticalSection Lock;
+		TMap<uint64, TUniquePtr<std::atomic<uint64>>> Counters;
+	};
+
+	struct FCallSiteTableRegistry
+	{
+		FCriticalSection Lock;
+		TArray<TSharedPtr<FThreadCallSiteTable, ESPMode::ThreadSafe>> Tables;
+	};
+
+	FCallSiteTableRegistry& GetTableRegistry()
+	{
+		static FCallSiteTableRegistry Registry;
+		return Registry;
+	}
+
+	FThreadCallSiteTable& GetThreadTable()
+	{
+		// The registry keeps the table alive after the thread exits, so its hits stay in the report.
+		thread_local TSharedPtr<FThreadCallSiteTable, ESPMode::ThreadSafe> ThreadTable;
+		if (!ThreadTable.IsValid())
+		{
+			ThreadTable = MakeShared<FThreadCallSiteTable, ESPMode::ThreadSafe>();
+			FCallSiteTableRegistry& Registry = GetTableRegistry();
+			FScopeLock RegistryLock(&Registry.Lock);
+			Registry.Tables.Add(ThreadTable);
+		}
+		return *ThreadTable;
+	}
+
+	TArray<TSharedPtr<FThreadCallSiteTable, ESPMode::ThreadSafe>> CopyTables()
+	{
+		FCallSiteTableRegistry& Registry = GetTableRegistry();
+		FScopeLock RegistryLock(&Registry.Lock);
+		return Registry.Tables;
+	}
+
+	FAutoConsoleCommand TopCallSitesCommand(
+		TEXT("DebugUtils.CallSites.Top"),
+		TEXT("Logs the call sites recorded by FCallSiteProfiler with the most hits. Usage: DebugUtils.CallSites.Top [Count=20]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 20;
+			UE_LOG(LogTemp, Display, TEXT("Top call sites:\n%s"), *FCallSiteProfiler::FormatTopCallSites(Count));
+		}));
+
+	FAutoConsoleCommand ResetCallSitesCommand(
+		TEXT("DebugUtils.CallSites.Reset"),
+		TEXT("Zeroes the hit counters of FCallSiteProfiler."),
+		FConsoleCommandDelegate::CreateStatic(&FCallSiteProfiler::Reset));
+}
+
+void FCallSiteProfiler::RecordHit(uint64 ProgramCounter)
+{
+	FThreadCallSiteTable& Table = GetThreadTable();
+	if (TUniquePtr<std::atomic<uint64>>* Counter = Table.Counters.Find(ProgramCounter))
+	{
+		(*Counter)->fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	FScopeLock TableLock(&Table.Lock);
+	Table.Counters.Add(ProgramCounter, MakeUnique<std::atomic<uint64>>(1));
+}
+
+TArray<FCallSiteHits> FCallSiteProfiler::GetTopCallSites(int32 Count)
+{
+	TMap<uint64, uint64> MergedHits;
+	for (const auto& Table : CopyTables())
+	{
+		FScopeLock TableLock(&Table->Lock);
+		for (const auto& Pair : Table->Counters)
+		{
+			MergedHits.FindOrAdd(Pair.Key) += Pair.Value->load(std::memory_order_relaxed);
+		}
+	}
+	TArray<FCallSiteHits> Result;
+	Result.Reserve(MergedHits.Num());
+	for (const auto& Pair : MergedHits)
+	{
+		if (Pair.Value > 0)
+		{
+			Result.Add({Pair.Key, Pair.Value});
+		}
+	}
+	Result.Sort([](const FCallSiteHits& A, const FCallSiteHits& B)
+	{
+		return A.Hits > B.Hits;
+	});
+	if (Result.Num() > Count)
+	{
+		Result.SetNum(FMath::Max(Count, 0));
+	}
+	return Result;
+}
+
+FString FCallSiteProfiler::FormatTopCallSites(int32 Count)
+{
+	FString Result;
+	FCachedSymbolInfo SymbolInfo;
+	for (const FCallSiteHits& CallSite : GetTopCallSites(Count))
+	{
+		const FString Location = FSymbolCache::Get().Resolve(CallSite.ProgramCounter, SymbolInfo)
+			                         ? SymbolInfo.ToString()
+			                         : FString::Printf(TEXT("0x%016llx"), CallSite.ProgramCounter);
+		Result += FString::Printf(TEXT("%12llu %s\n"), CallSite.Hits, *Location);
+	}
+	return Result;
+}
+
+void FCallSiteProfiler::Reset()
+{
+	for (const auto& Table : CopyTables())
+	{
+		FScopeLock TableLock(&Table->Lock);
+		for (const auto& Pair : Table->Counters)
+		{
+			Pair.Value->store(0, std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,27 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+
+struct FCallSiteHits
+{
+	uint64 ProgramCounter = 0;
+	uint64 Hits = 0;
+};
+
+/**
+ * Call-site histogram: counts hits per caller program counter.
+ * Each thread counts into its own table, so a hit on a known call site is a lock-free lookup and one relaxed
+ * atomic increment. Tables are only merged when a report is requested.
+ * Console commands: DebugUtils.CallSites.Top [Count], DebugUtils.CallSites.Reset
+ */
+class DEBUGUTILS_API FCallSiteProfiler
+{
+public:
+	/** Counts one hit for the call site. Thread-safe. */
+	static void RecordHit(uint64 ProgramCounter);
+	/** @return The most hit call sites across all threads, most hit first */
+	static TArray<FCallSiteHits> GetTopCallSites(int32 Count);
+	/** Symbolizes the top call sites, one "Hits File@Function:Line" line each. */
+	static FString FormatTopCallSites(int32 Count);
+	/** Zeroes every counter. Hits recorded concurrently may survive the reset. */
+	static void Reset();
+};
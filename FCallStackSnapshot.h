@@ -0,0 +1,24 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+
+/**
+ * Raw return addresses of a captured stack, innermost frame first. Nothing is symbolized at capture time,
+ * and stacks up to InlineFrames deep live entirely inside the snapshot.
+ * Format with UCallStack::FormatStack.
+ */
+struct FCallStackSnapshot
+{
+	static constexpr int32 InlineFrames = 32;
+
+	TArray<uint64, TInlineAllocator<InlineFrames>> ProgramCounters;
+
+	int32 Num() const
+	{
+		return ProgramCounters.Num();
+	}
+
+	bool IsEmpty() const
+	{
+		return ProgramCounters.Num() == 0;
+	}
+};
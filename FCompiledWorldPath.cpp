@@ -0,0 +1,126 @@
+﻿#include "FCompiledWorldPath.h"
+#include "FWorldPathIndex.h"
+#include "UWorldNavigator.h"
+#include "Engine/World.h"
+
+namespace
+{
+	// Adding or removing a level can shift the same-name level indices of any path, so it invalidates every cache.
+	uint32 LevelGeneration = 0;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+	void OnLevelChanged(ULevel*, UWorld*)
+	{
+		++LevelGeneration;
+	}
+}
+
+bool FCompiledWorldPath::TryCompile(FStringView Path, FString& ErrorMessage, FCompiledWorldPath& Result)
+{
+	Result.Invalidate();
+	return FCompiledPathStructure::TryCompile(Path, ErrorMessage, Result.Path);
+}
+
+AActor* FCompiledWorldPath::ResolveActor()
+{
+	if (UObject* Target = FindCachedTarget(ETargetKind::Actor))
+	{
+		return static_cast<AActor*>(Target);
+	}
+	AActor* Actor = UWorldNavigator::FindUActorByPath(Path);
+	CacheTarget(Actor, ETargetKind::Actor);
+	return Actor;
+}
+
+UActorComponent* FCompiledWorldPath::ResolveActorComponent()
+{
+	if (UObject* Target = FindCachedTarget(ETargetKind::ActorComponent))
+	{
+		return static_cast<UActorComponent*>(Target);
+	}
+	UActorComponent* Component = UWorldNavigator::FindActorComponentByPath(Path);
+	CacheTarget(Component, ETargetKind::ActorComponent);
+	return Component;
+}
+
+USceneComponent* FCompiledWorldPath::ResolveSceneComponent()
+{
+	if (UObject* Target = FindCachedTarget(ETargetKind::SceneComponent))
+	{
+		return static_cast<USceneComponent*>(Target);
+	}
+	USceneComponent* Component = UWorldNavigator::FindSceneComponentByPath(Path);
+	CacheTarget(Component, ETargetKind::SceneComponent);
+	return Component;
+}
+
+void FCompiledWorldPath::Invalidate()
+{
+	CachedTarget.Reset();
+	CachedWorld.Reset();
+	CachedKind = ETargetKind::None;
+}
+
+const FCompiledPathStructure& FCompiledWorldPath::GetPath() const
+{
+	return Path;
+}
+
+UObject* FCompiledWorldPath::FindCachedTarget(ETargetKind Kind) const
+{
+	if (CachedKind != Kind or CachedLevelGeneration != GetLevelGeneration())
+	{
+		return nullptr;
+	}
+	UObject* Target = CachedTarget.Get();
+	const UWorld* World = CachedWorld.Get();
+	if (Target == nullptr or World == nullptr)
+	{
+		return nullptr;
+	}
+	const FWorldPathIndex* Index = FWorldPathIndex::Find(World);
+	if (Index != nullptr and Index->GetGeneration() != CachedIndexGeneration)
+	{
+		return nullptr;
+	}
+	return Target;
+}
+
+void FCompiledWorldPath::CacheTarget(UObject* Target, ETargetKind Kind)
+{
+	UWorld* World = Target != nullptr ? Target->GetWorld() : nullptr;
+	if (World == nullptr)
+	{
+		Invalidate();
+		return;
+	}
+	const FWorldPathIndex* Index = FWorldPathIndex::Find(World);
+	CachedTarget = Target;
+	CachedWorld = World;
+	CachedKind = Kind;
+	CachedLevelGeneration = GetLevelGeneration();
+	CachedIndexGeneration = Index != nullptr ? Index->GetGeneration() : 0;
+}
+
+void FCompiledWorldPath::StartTrackingLevels()
+{
+	if (!LevelAddedHandle.IsValid())
+	{
+		LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddStatic(&OnLevelChanged);
+		LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddStatic(&OnLevelChanged);
+	}
+}
+
+void FCompiledWorldPath::StopTrackingLevels()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	LevelAddedHandle.Reset();
+	LevelRemovedHandle.Reset();
+}
+
+uint32 FCompiledWorldPath::GetLevelGeneration()
+{
+	return LevelGeneration;
+}
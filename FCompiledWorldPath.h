@@ -0,0 +1,55 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "FPathStructure.h"
+
+class AActor;
+class UActorComponent;
+class USceneComponent;
+class UWorld;
+
+/**
+ * World path compiled once from a string that remembers what it last resolved to.
+ * Re-resolving is a weak pointer and generation check in the common case; the full UWorldNavigator walk only runs
+ * again once the cached target was destroyed, its world went away, levels were added or removed, or the world's
+ * path index reports a change. Game thread only.
+ */
+class DEBUGUTILS_API FCompiledWorldPath
+{
+public:
+	FCompiledWorldPath() = default;
+
+	static bool TryCompile(FStringView Path, FString& ErrorMessage, FCompiledWorldPath& Result);
+
+	AActor* ResolveActor();
+	UActorComponent* ResolveActorComponent();
+	USceneComponent* ResolveSceneComponent();
+	/** Forgets the cached target so the next Resolve call walks the world again. */
+	void Invalidate();
+
+	const FCompiledPathStructure& GetPath() const;
+
+	/** Starts and stops counting level changes for every compiled path. Called from the module's startup and shutdown. */
+	static void StartTrackingLevels();
+	static void StopTrackingLevels();
+
+private:
+	enum class ETargetKind : uint8
+	{
+		None,
+		Actor,
+		ActorComponent,
+		SceneComponent
+	};
+
+	UObject* FindCachedTarget(ETargetKind Kind) const;
+	void CacheTarget(UObject* Target, ETargetKind Kind);
+	static uint32 GetLevelGeneration();
+
+	FCompiledPathStructure Path;
+	TWeakObjectPtr<UObject> CachedTarget;
+	TWeakObjectPtr<UWorld> CachedWorld;
+	ETargetKind CachedKind = ETargetKind::None;
+	uint32 CachedLevelGeneration = 0;
+	uint32 CachedIndexGeneration = 0;
+};
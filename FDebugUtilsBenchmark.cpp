@@ -0,0 +1,405 @@
+﻿#include "FDebugUtilsBenchmark.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "FPathStructure.h"
+#include "UCallStack.h"
+#include "URepr.h"
+#include "UWorldNavigator.h"
+#include "Components/SceneComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	/** Allocation counter of the thread currently measuring, or nullptr on every other thread */
+	thread_local int64* ThreadAllocationCounter = nullptr;
+
+	/**
+	 * Forwards to the real allocator and counts the allocations of the thread that set ThreadAllocationCounter.
+	 * It is put in front of GMalloc the first time a benchmark counts allocations and then stays there for the rest
+	 * of the process: other threads may be inside it or hold it at any time, so it is never removed or destroyed.
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		static void Install()
+		{
+			// Leaked on purpose, see above. Allocated through the allocator it wraps, which is never freed either.
+			static const FCountingMalloc* Instance = []
+			{
+				FCountingMalloc* Proxy = new FCountingMalloc(GMalloc);
+				FPlatformMisc::MemoryBarrier();
+				GMalloc = Proxy;
+				return Proxy;
+			}();
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Original == nullptr)
+			{
+				CountAllocation();
+			}
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			Inner->Free(Original);
+		}
+
+		virtual void InitializeStatsMetadata() override
+		{
+			Inner->InitializeStatsMetadata();
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			Inner->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			Inner->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			Inner->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual void UpdateStats() override
+		{
+			Inner->UpdateStats();
+		}
+
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+		{
+			Inner->GetAllocatorStats(OutStats);
+		}
+
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+		{
+			Inner->DumpAllocatorStats(Ar);
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return Inner->ValidateHeap();
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return Inner->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return Inner->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return Inner->IsInternallyThreadSafe();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return TEXT("DebugUtilsBenchmarkCountingMalloc");
+		}
+
+	private:
+		explicit FCountingMalloc(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		static void CountAllocation()
+		{
+			if (int64* Counter = ThreadAllocationCounter)
+			{
+				++*Counter;
+			}
+		}
+
+		FMalloc* Inner;
+	};
+
+	/**
+	 * Runs Operation until both the minimum iteration count and the minimum duration are reached, then runs it
+	 * once more per iteration while counting this thread's allocations.
+	 */
+	FDebugUtilsBenchmarkResult Measure(const FDebugUtilsBenchmarkSettings& Settings, const TCHAR* Name,
+	                                   TFunctionRef<void(int32)> Operation)
+	{
+		FDebugUtilsBenchmarkResult Result;
+		Result.Name = Name;
+		// One untimed pass so lazily built caches do not count against the first iterations.
+		Operation(0);
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		const uint64 MinCycles = static_cast<uint64>(Settings.MinSeconds / FPlatformTime::GetSecondsPerCycle64());
+		int64 Iterations = 0;
+		while (Iterations < Settings.MinIterations or FPlatformTime::Cycles64() - StartCycles < MinCycles)
+		{
+			Operation(static_cast<int32>(Iterations));
+			++Iterations;
+		}
+		const double Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+		Result.Iterations = Iterations;
+		Result.NanosecondsPerOp = Seconds * 1e9 / Iterations;
+
+		const int64 CountedIterations = FMath::Min<int64>(Iterations, Settings.MinIterations);
+		FCountingMalloc::Install();
+		int64 NumAllocations = 0;
+		ThreadAllocationCounter = &NumAllocations;
+		for (int64 i = 0; i < CountedIterations; ++i)
+		{
+			Operation(static_cast<int32>(i));
+		}
+		ThreadAllocationCounter = nullptr;
+		Result.AllocationsPerOp = static_cast<double>(NumAllocations) / CountedIterations;
+		return Result;
+	}
+
+	struct FSyntheticWorld
+	{
+		UWorld* World = nullptr;
+		TArray<AActor*> Actors;
+		/** The deepest component of each attach chain */
+		TArray<USceneComponent*> Leaves;
+	};
+
+	FSyntheticWorld CreateSyntheticWorld(const FDebugUtilsBenchmarkSettings& Settings)
+	{
+		FSyntheticWorld Result;
+		Result.World = UWorld::CreateWorld(EWorldType::Inactive, false, TEXT("DebugUtilsBenchmarkWorld"));
+		TArray<ULevel*> Levels;
+		Levels.Add(Result.World->PersistentLevel);
+		for (int32 LevelIndex = 1; LevelIndex < Settings.NumLevels; ++LevelIndex)
+		{
+			ULevel* Level = NewObject<ULevel>(Result.World, *FString::Printf(TEXT("BenchmarkLevel_%d"), LevelIndex));
+			Level->Initialize(FURL());
+			Level->OwningWorld = Result.World;
+			Result.World->AddLevel(Level);
+			Levels.Add(Level);
+		}
+		const int32 Depth = FMath::Max(Settings.AttachmentDepth, 1);
+		for (ULevel* Level : Levels)
+		{
+			for (int32 ActorIndex = 0; ActorIndex < Settings.NumActorsPerLevel; ++ActorIndex)
+			{
+				FActorSpawnParameters SpawnParameters;
+				SpawnParameters.OverrideLevel = Level;
+				SpawnParameters.Name = *FString::Printf(TEXT("BenchmarkActor_%d"), ActorIndex);
+				AActor* Actor = Result.World->SpawnActor<AActor>(SpawnParameters);
+				if (Actor == nullptr)
+				{
+					continue;
+				}
+				Result.Actors.Add(Actor);
+				USceneComponent* Root = NewObject<USceneComponent>(Actor, TEXT("Root"));
+				Actor->SetRootComponent(Root);
+				USceneComponent* Parent = Root;
+				for (int32 ComponentIndex = 0; ComponentIndex < Settings.NumComponentsPerActor; ++ComponentIndex)
+				{
+					if (ComponentIndex % Depth == 0)
+					{
+						if (Parent != Root)
+						{
+							Result.Leaves.Add(Parent);
+						}
+						Parent = Root;
+					}
+					USceneComponent* Component = NewObject<USceneComponent>(
+						Actor, *FString::Printf(TEXT("Component_%d"), ComponentIndex));
+					Component->AttachToComponent(Parent, FAttachmentTransformRules::KeepRelativeTransform);
+					Parent = Component;
+				}
+				Result.Leaves.Add(Parent);
+			}
+		}
+		return Result;
+	}
+
+	void DestroySyntheticWorld(FSyntheticWorld& SyntheticWorld)
+	{
+		UWorldNavigator::SetPathIndexEnabled(SyntheticWorld.World, false);
+		SyntheticWorld.World->DestroyWorld(false);
+		SyntheticWorld.World->RemoveFromRoot();
+		SyntheticWorld = FSyntheticWorld();
+	}
+
+	template <typename T>
+	TArray<T> PickSamples(const TArray<T>& Objects, int32 NumSamples)
+	{
+		TArray<T> Samples;
+		if (Objects.Num() == 0)
+		{
+			return Samples;
+		}
+		const int32 Num = FMath::Clamp(NumSamples, 1, Objects.Num());
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Samples.Add(Objects[static_cast<int64>(i) * Objects.Num() / Num]);
+		}
+		return Samples;
+	}
+
+	void MeasurePathLookups(const FDebugUtilsBenchmarkSettings& Settings, const FSyntheticWorld& SyntheticWorld,
+	                        const TCHAR* Suffix, TArray<FDebugUtilsBenchmarkResult>& Results)
+	{
+		const TArray<USceneComponent*> Leaves = PickSamples(SyntheticWorld.Leaves, Settings.NumSamples);
+		if (Leaves.Num() == 0)
+		{
+			return;
+		}
+		TArray<FString> ScenePaths;
+		TArray<FString> ComponentPaths;
+		for (USceneComponent* Leaf : Leaves)
+		{
+			ScenePaths.Add(UWorldNavigator::GetWorldPath(Leaf));
+			ComponentPaths.Add(UWorldNavigator::GetWorldPath(Leaf->GetOwner()) + TEXT("->") + Leaf->GetName()
+				+ TEXT("[0]"));
+		}
+		Results.Add(Measure(Settings, *FString::Printf(TEXT("GetWorldPath(USceneComponent*)%s"), Suffix),
+		                    [&](int32 i)
+		                    {
+			                    UWorldNavigator::GetWorldPath(Leaves[i % Leaves.Num()]);
+		                    }));
+		Results.Add(Measure(Settings, *FString::Printf(TEXT("FindActorComponentByPath%s"), Suffix), [&](int32 i)
+		{
+			UWorldNavigator::FindActorComponentByPath(ComponentPaths[i % ComponentPaths.Num()]);
+		}));
+		Results.Add(Measure(Settings, *FString::Printf(TEXT("FindSceneComponentByPath%s"), Suffix), [&](int32 i)
+		{
+			UWorldNavigator::FindSceneComponentByPath(ScenePaths[i % ScenePaths.Num()]);
+		}));
+	}
+
+	FAutoConsoleCommand BenchmarkCommand(
+		TEXT("DebugUtils.Benchmark"),
+		TEXT("Benchmarks DebugUtils against a synthetic world and writes a CSV to the profiling directory. ")
+		TEXT("Usage: DebugUtils.Benchmark [Levels=1] [ActorsPerLevel=1000] [ComponentsPerActor=8] [AttachmentDepth=4] [CsvPath]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			FDebugUtilsBenchmarkSettings Settings;
+			int32* const IntArgs[] = {
+				&Settings.NumLevels, &Settings.NumActorsPerLevel, &Settings.NumComponentsPerActor,
+				&Settings.AttachmentDepth
+			};
+			for (int32 i = 0; i < UE_ARRAY_COUNT(IntArgs) and i < Args.Num(); ++i)
+			{
+				*IntArgs[i] = FMath::Max(FCString::Atoi(*Args[i]), 1);
+			}
+			const auto CsvPath = Args.Num() > UE_ARRAY_COUNT(IntArgs)
+				                     ? Args[UE_ARRAY_COUNT(IntArgs)]
+				                     : FPaths::ProfilingDir() / TEXT("DebugUtils") / FString::Printf(
+					                     TEXT("Benchmark-%s.csv"), *FDateTime::Now().ToString());
+			const auto Results = FDebugUtilsBenchmark::Run(Settings);
+			for (const auto& Result : Results)
+			{
+				UE_LOG(LogTemp, Display, TEXT("%-48s %12.1f ns/op %8.2f allocs/op (%lld iterations)"), *Result.Name,
+				       Result.NanosecondsPerOp, Result.AllocationsPerOp, Result.Iterations);
+			}
+			if (FFileHelper::SaveStringToFile(FDebugUtilsBenchmark::ToCsv(Results), *CsvPath))
+			{
+				UE_LOG(LogTemp, Display, TEXT("Benchmark results written to %s"), *CsvPath);
+			}
+		}));
+}
+
+TArray<FDebugUtilsBenchmarkResult> FDebugUtilsBenchmark::Run(const FDebugUtilsBenchmarkSettings& Settings)
+{
+	check(IsInGameThread());
+	TArray<FDebugUtilsBenchmarkResult> Results;
+	FSyntheticWorld SyntheticWorld = CreateSyntheticWorld(Settings);
+	MeasurePathLookups(Settings, SyntheticWorld, TEXT(""), Results);
+	UWorldNavigator::SetPathIndexEnabled(SyntheticWorld.World, true);
+	MeasurePathLookups(Settings, SyntheticWorld, TEXT(" [index]"), Results);
+
+	const TArray<USceneComponent*> Leaves = PickSamples(SyntheticWorld.Leaves, Settings.NumSamples);
+	TArray<FString> Paths;
+	for (USceneComponent* Leaf : Leaves)
+	{
+		Paths.Add(UWorldNavigator::GetWorldPath(Leaf));
+	}
+	DestroySyntheticWorld(SyntheticWorld);
+
+	if (Paths.Num() > 0)
+	{
+		Results.Add(Measure(Settings, TEXT("FPathStructure::TryParse"), [&](int32 i)
+		{
+			FString ErrorMessage;
+			FPathStructure Path;
+			FPathStructure::TryParse(Paths[i % Paths.Num()], ErrorMessage, Path);
+		}));
+		Results.Add(Measure(Settings, TEXT("FPathStructureView::TryParse"), [&](int32 i)
+		{
+			FString ErrorMessage;
+			FPathStructureView Path;
+			FPathStructureView::TryParse(Paths[i % Paths.Num()], ErrorMessage, Path);
+		}));
+	}
+
+	TMap<FString, TArray<TOptional<int32>>> NestedContainer;
+	for (int32 i = 0; i < 16; ++i)
+	{
+		auto& Values = NestedContainer.Add(FString::Printf(TEXT("Key%d"), i));
+		for (int32 j = 0; j < 16; ++j)
+		{
+			Values.Add(j % 3 == 0 ? TOptional<int32>() : TOptional<int32>(i * j));
+		}
+	}
+	Results.Add(Measure(Settings, TEXT("Repr(TMap<FString, TArray<TOptional<int32>>>)"), [&](int32)
+	{
+		Repr(NestedContainer);
+	}));
+
+	TArray<float> Floats;
+	Floats.SetNumUninitialized(1000000);
+	for (int32 i = 0; i < Floats.Num(); ++i)
+	{
+		Floats[i] = i * 0.37f;
+	}
+	FDebugUtilsBenchmarkSettings LargeSettings = Settings;
+	LargeSettings.MinIterations = 3;
+	Results.Add(Measure(LargeSettings, TEXT("Repr(TArray<float>) 1M"), [&](int32)
+	{
+		Repr(Floats);
+	}));
+
+	Results.Add(Measure(Settings, TEXT("UCallStack::GetCallerInfo"), [](int32)
+	{
+		UCallStack::GetCallerInfo();
+	}));
+	Results.Add(Measure(Settings, TEXT("UE_CALLER_INFO"), [](int32)
+	{
+		UE_CALLER_INFO();
+	}));
+	return Results;
+}
+
+FString FDebugUtilsBenchmark::ToCsv(const TArray<FDebugUtilsBenchmarkResult>& Results)
+{
+	FString Csv = TEXT("Benchmark,Iterations,NsPerOp,AllocsPerOp\n");
+	for (const auto& Result : Results)
+	{
+		Csv += FString::Printf(TEXT("\"%s\",%lld,%.2f,%.3f\n"), *Result.Name, Result.Iterations,
+		                       Result.NanosecondsPerOp, Result.AllocationsPerOp);
+	}
+	return Csv;
+}
+
+#endif
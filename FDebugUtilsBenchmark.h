@@ -0,0 +1,43 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+struct FDebugUtilsBenchmarkSettings
+{
+	int32 NumLevels = 1;
+	int32 NumActorsPerLevel = 1000;
+	int32 NumComponentsPerActor = 8;
+	/** Length of the attach chains the components of each actor are arranged in */
+	int32 AttachmentDepth = 4;
+	/** Objects each lookup benchmark cycles through */
+	int32 NumSamples = 1024;
+	int32 MinIterations = 1000;
+	double MinSeconds = 0.2;
+};
+
+struct FDebugUtilsBenchmarkResult
+{
+	FString Name;
+	int64 Iterations = 0;
+	double NanosecondsPerOp = 0.0;
+	double AllocationsPerOp = 0.0;
+};
+
+/**
+ * Measures ns/op and allocations/op of the DebugUtils hot paths against a synthetic world that is created and
+ * destroyed for the run. Allocations are counted on the game thread only, through an FMalloc proxy that the first run
+ * puts in front of GMalloc for the rest of the process; other threads' allocations pass through it uncounted.
+ * Console command: DebugUtils.Benchmark [Levels] [ActorsPerLevel] [ComponentsPerActor] [AttachmentDepth] [CsvPath]
+ * Automation test: DebugUtils.Benchmark, in the perf filter, with the default settings.
+ * Game thread only.
+ */
+class DEBUGUTILS_API FDebugUtilsBenchmark
+{
+public:
+	static TArray<FDebugUtilsBenchmarkResult> Run(const FDebugUtilsBenchmarkSettings& Settings);
+	/** @return One "Benchmark,Iterations,NsPerOp,AllocsPerOp" header line and one line per result */
+	static FString ToCsv(const TArray<FDebugUtilsBenchmarkResult>& Results);
+};
+
+#endif
@@ -0,0 +1,33 @@
+﻿#include "FDebugUtilsBenchmark.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDebugUtilsBenchmarkTest, "DebugUtils.Benchmark",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+                                 | EAutomationTestFlags::PerfFilter)
+
+bool FDebugUtilsBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// Same suite and defaults as the DebugUtils.Benchmark console command, so automation runs can track regressions.
+	const FDebugUtilsBenchmarkSettings Settings;
+	const auto Results = FDebugUtilsBenchmark::Run(Settings);
+	TestTrue(TEXT("Benchmarks ran"), Results.Num() > 0);
+	for (const auto& Result : Results)
+	{
+		TestTrue(*FString::Printf(TEXT("%s iterations"), *Result.Name), Result.Iterations > 0);
+		AddInfo(FString::Printf(TEXT("%s: %.1f ns/op, %.2f allocs/op (%lld iterations)"), *Result.Name,
+		                        Result.NanosecondsPerOp, Result.AllocationsPerOp, Result.Iterations));
+	}
+	const FString CsvPath = FPaths::ProfilingDir() / TEXT("DebugUtils") / FString::Printf(
+		TEXT("Benchmark-Automation-%s.csv"), *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(FDebugUtilsBenchmark::ToCsv(Results), *CsvPath))
+	{
+		AddInfo(FString::Printf(TEXT("Benchmark results written to %s"), *CsvPath));
+	}
+	return true;
+}
+
+#endif
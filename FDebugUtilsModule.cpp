@@ -0,0 +1,20 @@
+﻿#include "FDebugUtilsModule.h"
+#include "FCompiledWorldPath.h"
+#include "FReprLogSink.h"
+#include "FWorldNavigationSnapshot.h"
+#include "Modules/ModuleManager.h"
+
+void FDebugUtilsModule::StartupModule()
+{
+	FCompiledWorldPath::StartTrackingLevels();
+	FWorldNavigationSnapshot::StartTrackingWorlds();
+}
+
+void FDebugUtilsModule::ShutdownModule()
+{
+	FReprLogSink::Get().Stop();
+	FWorldNavigationSnapshot::StopTrackingWorlds();
+	FCompiledWorldPath::StopTrackingLevels();
+}
+
+IMPLEMENT_MODULE(FDebugUtilsModule, DebugUtils)
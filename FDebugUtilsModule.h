@@ -0,0 +1,14 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "Modules/ModuleInterface.h"
+
+/**
+ * Owns the process-wide engine hooks of DebugUtils, so they are added once the module loads and removed before it
+ * unloads or hot reloads instead of dangling from function-local statics.
+ */
+class FDebugUtilsModule final : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};
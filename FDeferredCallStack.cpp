@@ -0,0 +1,155 @@
+﻿#include "FDeferredCallStack.h"
+#include "DebugUtilsStats.h"
+#include "UCallStack.h"
+#include "Async/Async.h"
+#include "HAL/PlatformStackWalk.h"
+#include "Misc/ScopeRWLock.h"
+#include <atomic>
+
+namespace
+{
+	constexpr int32 MaxIgnoreCount = 16;
+
+	struct FRingSlot
+	{
+		/** Odd while the owning thread writes the slot, 2 * (Sequence + 1) once the slot holds that sequence. */
+		std::atomic<uint64> Version{0};
+		std::atomic<uint32> NumFrames{0};
+		std::atomic<uint64> ProgramCounters[FDeferredCallStack::MaxFrames];
+	};
+
+	struct FRing
+	{
+		/** Only written by the owning thread. */
+		std::atomic<uint32> NextSequence{0};
+		FRingSlot Slots[FDeferredCallStack::RingCapacity];
+	};
+
+	/**
+	 * Rings are owned here rather than by the threads, so handles stay readable after their thread exits.
+	 * The registry only grows, by one ring per recording thread.
+	 */
+	struct FRingRegistry
+	{
+		FRWLock Lock;
+		TArray<TUniquePtr<FRing>> Rings;
+
+		FRing* Find(uint32 RingIndex)
+		{
+			FReadScopeLock ReadLock(Lock);
+			return Rings.IsValidIndex(RingIndex) ? Rings[RingIndex].Get() : nullptr;
+		}
+	};
+
+	FRingRegistry& GetRingRegistry()
+	{
+		static FRingRegistry Registry;
+		return Registry;
+	}
+
+	struct FThreadRing
+	{
+		FRing* Ring = nullptr;
+		uint32 RingIndex = 0;
+	};
+
+	FThreadRing& GetThreadRing()
+	{
+		thread_local FThreadRing ThreadRing;
+		if (ThreadRing.Ring == nullptr)
+		{
+			FRingRegistry& Registry = GetRingRegistry();
+			FWriteScopeLock WriteLock(Registry.Lock);
+			ThreadRing.RingIndex = Registry.Rings.Num();
+			ThreadRing.Ring = Registry.Rings.Add_GetRef(MakeUnique<FRing>()).Get();
+		}
+		return ThreadRing;
+	}
+}
+
+FDeferredCallStackHandle FDeferredCallStack::Record(int32 Depth, int32 IgnoreCount)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_CaptureStack);
+	Depth = FMath::Clamp(Depth, 1, MaxFrames);
+	IgnoreCount = FMath::Clamp(IgnoreCount, 0, MaxIgnoreCount);
+	uint64 BackTrace[MaxIgnoreCount + MaxFrames] = {};
+	const uint32 CapturedDepth = FPlatformStackWalk::CaptureStackBackTrace(BackTrace, IgnoreCount + Depth);
+	const int32 NumFrames = FMath::Max(static_cast<int32>(CapturedDepth) - IgnoreCount, 0);
+
+	FThreadRing& ThreadRing = GetThreadRing();
+	FRing& Ring = *ThreadRing.Ring;
+	const uint32 Sequence = Ring.NextSequence.load(std::memory_order_relaxed);
+	Ring.NextSequence.store(Sequence + 1, std::memory_order_relaxed);
+	FRingSlot& Slot = Ring.Slots[Sequence % RingCapacity];
+
+	Slot.Version.store(2 * static_cast<uint64>(Sequence) + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (int32 i = 0; i < NumFrames; ++i)
+	{
+		Slot.ProgramCounters[i].store(BackTrace[IgnoreCount + i], std::memory_order_relaxed);
+	}
+	Slot.NumFrames.store(NumFrames, std::memory_order_relaxed);
+	Slot.Version.store(2 * (static_cast<uint64>(Sequence) + 1), std::memory_order_release);
+
+	FDeferredCallStackHandle Handle;
+	Handle.RingIndex = ThreadRing.RingIndex;
+	Handle.Sequence = Sequence;
+	return Handle;
+}
+
+bool FDeferredCallStack::GetProgramCounters(FDeferredCallStackHandle Handle, FCallStackSnapshot& Result)
+{
+	Result.ProgramCounters.Reset();
+	if (!Handle.IsValid())
+	{
+		return false;
+	}
+	FRing* Ring = GetRingRegistry().Find(Handle.RingIndex);
+	if (Ring == nullptr)
+	{
+		return false;
+	}
+	const FRingSlot& Slot = Ring->Slots[Handle.Sequence % RingCapacity];
+	const uint64 ExpectedVersion = 2 * (static_cast<uint64>(Handle.Sequence) + 1);
+	if (Slot.Version.load(std::memory_order_acquire) != ExpectedVersion)
+	{
+		return false;
+	}
+	const int32 NumFrames = FMath::Min(static_cast<int32>(Slot.NumFrames.load(std::memory_order_relaxed)), MaxFrames);
+	for (int32 i = 0; i < NumFrames; ++i)
+	{
+		Result.ProgramCounters.Add(Slot.ProgramCounters[i].load(std::memory_order_relaxed));
+	}
+	// The owning thread may have wrapped around and started rewriting the slot while it was copied.
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (Slot.Version.load(std::memory_order_relaxed) != ExpectedVersion)
+	{
+		Result.ProgramCounters.Reset();
+		return false;
+	}
+	return true;
+}
+
+FString FDeferredCallStack::Resolve(FDeferredCallStackHandle Handle)
+{
+	FCallStackSnapshot Snapshot;
+	if (!GetProgramCounters(Handle, Snapshot))
+	{
+		return TEXT("[unknown]");
+	}
+	return UCallStack::FormatStack(Snapshot);
+}
+
+TFuture<FString> FDeferredCallStack::ResolveAsync(FDeferredCallStackHandle Handle)
+{
+	FCallStackSnapshot Snapshot;
+	if (!GetProgramCounters(Handle, Snapshot))
+	{
+		return MakeFulfilledPromise<FString>(TEXT("[unknown]")).GetFuture();
+	}
+	return Async(EAsyncExecution::ThreadPool, [Snapshot = MoveTemp(Snapshot)]()
+	{
+		return UCallStack::FormatStack(Snapshot);
+	});
+}
+
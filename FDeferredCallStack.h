@@ -0,0 +1,56 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "FCallStackSnapshot.h"
+
+/**
+ * Refers to a backtrace recorded by FDeferredCallStack. Two integers, cheap to copy and store next to trace events.
+ * A handle goes stale once its thread has recorded RingCapacity newer backtraces.
+ */
+struct FDeferredCallStackHandle
+{
+	uint32 RingIndex = MAX_uint32;
+	uint32 Sequence = 0;
+
+	bool IsValid() const
+	{
+		return RingIndex != MAX_uint32;
+	}
+};
+
+/**
+ * Records raw return addresses at call time and symbolizes them later, off the hot path.
+ * Every thread writes to its own ring buffer without locks or allocations; readers on other threads detect
+ * slots that were overwritten while they copied them through a per-slot sequence counter.
+ */
+class DEBUGUTILS_API FDeferredCallStack
+{
+public:
+	static constexpr int32 MaxFrames = 16;
+	static constexpr uint32 RingCapacity = 1024;
+
+	/**
+	 * Records the return addresses of the caller's callers.
+	 * @param Depth The number of frames to keep, at most MaxFrames
+	 * @param IgnoreCount Frames to skip, counted like FPlatformStackWalk::GetStack
+	 */
+	static FORCENOINLINE FDeferredCallStackHandle Record(int32 Depth, int32 IgnoreCount);
+
+	/**
+	 * Copies the raw addresses of a recorded backtrace.
+	 * @return Whether the backtrace was still in its ring buffer
+	 */
+	static bool GetProgramCounters(FDeferredCallStackHandle Handle, FCallStackSnapshot& Result);
+
+	/**
+	 * Symbolizes a recorded backtrace on the calling thread, one "File@Function:Line" line per frame.
+	 * @return The formatted backtrace, or "[unknown]" if it was overwritten or could not be symbolized
+	 */
+	static FString Resolve(FDeferredCallStackHandle Handle);
+
+	/**
+	 * Copies the addresses right away and symbolizes them on a background thread.
+	 * The future is fulfilled with the same string Resolve would return.
+	 */
+	static TFuture<FString> ResolveAsync(FDeferredCallStackHandle Handle);
+};
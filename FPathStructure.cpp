@@ -1,167 +1,168 @@
 ﻿#include "FPathStructure.h"
+#include "DebugUtilsStats.h"
 
-enum ECurrentFillingMode
+bool FPathStructureView::TryParse(FStringView Path, FString& ErrorMessage, FPathStructureView& Result)
 {
-	World,
-	Level,
-	LevelIdx,
-	Actor,
-	ActorIdx,
-	Component,
-	ComponentIndex
-};
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_ParsePath);
+	Result.ComponentNames.Reset();
+	Result.ComponentIndices.Reset();
+	int32 WorldEnd = INDEX_NONE;
+	if (!Path.FindChar(TEXT('@'), WorldEnd))
+	{
+		ErrorMessage = TEXT("Missing required path components");
+		return false;
+	}
+	const int32 LevelStart = WorldEnd + 1;
+	const int32 LevelEnd = FindSeparator(Path, ':', '/', LevelStart);
+	if (LevelEnd == INDEX_NONE)
+	{
+		ErrorMessage = TEXT("Missing required path components");
+		return false;
+	}
+	const int32 ActorStart = LevelEnd + 2;
+	int32 ActorEnd = FindSeparator(Path, '-', '>', ActorStart);
+	const int32 ComponentStart = ActorEnd == INDEX_NONE ? Path.Len() : ActorEnd + 2;
+	if (ActorEnd == INDEX_NONE)
+	{
+		ActorEnd = Path.Len();
+	}
 
-bool FPathStructure::TryParse(const FString& Path, FString& ErrorMessage, FPathStructure& Result)
-{
-	FString WorldName;
-	FString LevelName;
-	int32 LevelIndexNumber = 0;
-	FString ActorName;
-	int32 ActorIndexNumber = 0;
-	TArray<FString> ComponentNames;
-	TArray<int32> ComponentIndices;
-	FString WorldSection, LevelSection, ActorSection, ComponentSection, LevelIndexSection, ActorIndexSection,
-	        ComponentIndexSection;
-	ECurrentFillingMode CurrentFillingMode = World;
-	bool SkipNext = false;
-	for (int32 i = 0; i < Path.Len(); ++i)
-	{
-		if (SkipNext)
-		{
-			SkipNext = false;
-			continue;
-		}
-		if (Path[i] == '@')
-		{
-			WorldName = WorldSection;
-			CurrentFillingMode = Level;
-			continue;
-		}
-		if (i < Path.Len() - 1 and Path[i] == ':' and Path[i + 1] == '/')
-		{
-			LevelName = LevelSection;
-			int32 LevelIndex = 0;
-			bool ParseResult = TryParseInt(LevelIndexSection, LevelIndex);
-			if (!ParseResult)
-			{
-				ErrorMessage = FString::Printf(TEXT("Failed to parse level index: %s"), *LevelIndexSection);
-				return false;
-			}
-			LevelIndexNumber = LevelIndex;
-			CurrentFillingMode = Actor;
-			SkipNext = true;
-			continue;
-		}
-		if (i < Path.Len() - 1 and Path[i] == '-' and Path[i + 1] == '>')
-		{
-			CurrentFillingMode = Component;
-			SkipNext = true;
-			continue;
-		}
-		if (Path[i] == '[' and CurrentFillingMode == Level)
-		{
-			CurrentFillingMode = LevelIdx;
-			continue;
-		}
-		if (Path[i] == ']' and CurrentFillingMode == LevelIdx)
-		{
-			CurrentFillingMode = Level;
-			continue;
-		}
-		if (Path[i] == '[' and CurrentFillingMode == Actor)
-		{
-			CurrentFillingMode = ActorIdx;
-			continue;
-		}
-		if (Path[i] == ']' and CurrentFillingMode == ActorIdx)
-		{
-			ActorName = ActorSection;
-			int32 ActorIndex = 0;
-			bool ParseResult = TryParseInt(ActorIndexSection, ActorIndex);
-			if (!ParseResult)
-			{
-				ErrorMessage = FString::Printf(TEXT("Failed to parse actor index: %s"), *ActorIndexSection);
-				return false;
-			}
-			ActorIndexNumber = ActorIndex;
-			CurrentFillingMode = Actor;
-			continue;
-		}
-		if (Path[i] == '[' and CurrentFillingMode == Component)
-		{
-			CurrentFillingMode = ComponentIndex;
-			continue;
-		}
-		if (Path[i] == ']' and CurrentFillingMode == ComponentIndex)
+	Result.WorldName = Path.Left(WorldEnd);
+	FStringView IndexString;
+	if (!TryParseIndexedName(Path.Mid(LevelStart, LevelEnd - LevelStart), Result.LevelName, IndexString)
+		or !FPathStructure::TryParseInt(IndexString, Result.LevelIndex))
+	{
+		ErrorMessage = FString::Printf(TEXT("Failed to parse level index: %.*s"), IndexString.Len(),
+		                               IndexString.GetData());
+		return false;
+	}
+	if (!TryParseIndexedName(Path.Mid(ActorStart, ActorEnd - ActorStart), Result.ActorName, IndexString)
+		or !FPathStructure::TryParseInt(IndexString, Result.ActorIndex))
+	{
+		ErrorMessage = FString::Printf(TEXT("Failed to parse actor index: %.*s"), IndexString.Len(),
+		                               IndexString.GetData());
+		return false;
+	}
+	int32 SegmentStart = ComponentStart;
+	for (int32 i = ComponentStart; i <= Path.Len(); ++i)
+	{
+		if (i < Path.Len() and Path[i] != '/')
 		{
-			CurrentFillingMode = Component;
 			continue;
 		}
-		if (Path[i] == '/' and CurrentFillingMode == Component)
+		const FStringView Segment = Path.Mid(SegmentStart, i - SegmentStart);
+		SegmentStart = i + 1;
+		if (Segment.IsEmpty())
 		{
-			ComponentNames.Add(ComponentSection);
-			int32 ComponentIndex = 0;
-			bool ParseResult = TryParseInt(ComponentIndexSection, ComponentIndex);
-			if (!ParseResult)
-			{
-				ErrorMessage = FString::Printf(TEXT("Failed to parse component index: %s"), *ComponentIndexSection);
-				return false;
-			}
-			ComponentIndices.Add(ComponentIndex);
-			ComponentSection = "";
-			ComponentIndexSection = "";
 			continue;
 		}
-		if (CurrentFillingMode == World)
-		{
-			WorldSection += Path[i];
-		}
-		if (CurrentFillingMode == Level)
+		FStringView ComponentName;
+		int32 ComponentIndex = 0;
+		if (!TryParseIndexedName(Segment, ComponentName, IndexString)
+			or !FPathStructure::TryParseInt(IndexString, ComponentIndex))
 		{
-			LevelSection += Path[i];
-		}
-		if (CurrentFillingMode == Actor)
-		{
-			ActorSection += Path[i];
-		}
-		if (CurrentFillingMode == Component)
-		{
-			ComponentSection += Path[i];
-		}
-		if (CurrentFillingMode == LevelIdx)
-		{
-			LevelIndexSection += Path[i];
-		}
-		if (CurrentFillingMode == ActorIdx)
-		{
-			ActorIndexSection += Path[i];
+			ErrorMessage = FString::Printf(TEXT("Failed to parse component index: %.*s"), IndexString.Len(),
+			                               IndexString.GetData());
+			return false;
 		}
-		if (CurrentFillingMode == ComponentIndex)
+		Result.ComponentNames.Add(ComponentName);
+		Result.ComponentIndices.Add(ComponentIndex);
+	}
+	if (Result.WorldName.IsEmpty() or Result.LevelName.IsEmpty() or Result.ActorName.IsEmpty())
+	{
+		ErrorMessage = TEXT("Missing required path components");
+		return false;
+	}
+	return true;
+}
+
+void FPathStructureView::MaterializeTo(FPathStructure& Result) const
+{
+	Result.WorldName = FString(WorldName);
+	Result.LevelName = FString(LevelName);
+	Result.LevelIndex = LevelIndex;
+	Result.ActorName = FString(ActorName);
+	Result.ActorIndex = ActorIndex;
+	Result.ComponentNames.Reset(ComponentNames.Num());
+	for (const FStringView ComponentName : ComponentNames)
+	{
+		Result.ComponentNames.Emplace(ComponentName);
+	}
+	Result.ComponentIndices = ComponentIndices;
+}
+
+bool FPathStructureView::TryParseIndexedName(FStringView Section, FStringView& Name, FStringView& IndexString)
+{
+	// A missing index means the first object with that name, e.g. "PersistentLevel" is "PersistentLevel[0]".
+	int32 OpenIndex = INDEX_NONE;
+	if (!Section.FindChar(TEXT('['), OpenIndex))
+	{
+		Name = Section;
+		IndexString = FStringView();
+		return true;
+	}
+	Name = Section.Left(OpenIndex);
+	IndexString = Section.Mid(OpenIndex + 1);
+	if (IndexString.IsEmpty() or IndexString[IndexString.Len() - 1] != ']')
+	{
+		return false;
+	}
+	IndexString.RemoveSuffix(1);
+	return true;
+}
+
+int32 FPathStructureView::FindSeparator(FStringView Path, TCHAR First, TCHAR Second, int32 StartIndex)
+{
+	for (int32 i = StartIndex; i < Path.Len() - 1; ++i)
+	{
+		if (Path[i] == First and Path[i + 1] == Second)
 		{
-			ComponentIndexSection += Path[i];
+			return i;
 		}
 	}
-	if (WorldName.IsEmpty() or LevelName.IsEmpty() or ActorName.IsEmpty())
+	return INDEX_NONE;
+}
+
+bool FCompiledPathStructure::TryCompile(FStringView Path, FString& ErrorMessage, FCompiledPathStructure& Result,
+                                        EFindName FindType)
+{
+	FPathStructureView View;
+	if (!FPathStructureView::TryParse(Path, ErrorMessage, View))
 	{
-		ErrorMessage = TEXT("Missing required path components");
 		return false;
 	}
-	if (ComponentNames.Num() != ComponentIndices.Num())
+	Compile(View, Result, FindType);
+	return true;
+}
+
+void FCompiledPathStructure::Compile(const FPathStructureView& View, FCompiledPathStructure& Result,
+                                     EFindName FindType)
+{
+	Result.WorldName = FName(View.WorldName.Len(), View.WorldName.GetData(), FindType);
+	Result.LevelName = FName(View.LevelName.Len(), View.LevelName.GetData(), FindType);
+	Result.LevelIndex = View.LevelIndex;
+	Result.ActorName = FName(View.ActorName.Len(), View.ActorName.GetData(), FindType);
+	Result.ActorIndex = View.ActorIndex;
+	Result.ComponentNames.Reset(View.ComponentNames.Num());
+	for (const FStringView ComponentName : View.ComponentNames)
+	{
+		Result.ComponentNames.Emplace(ComponentName.Len(), ComponentName.GetData(), FindType);
+	}
+	Result.ComponentIndices = View.ComponentIndices;
+}
+
+bool FPathStructure::TryParse(const FString& Path, FString& ErrorMessage, FPathStructure& Result)
+{
+	FPathStructureView View;
+	if (!FPathStructureView::TryParse(Path, ErrorMessage, View))
 	{
-		ErrorMessage = TEXT("Component names and indices must be the same length");
 		return false;
 	}
-	Result.WorldName = WorldName;
-	Result.LevelName = LevelName;
-	Result.LevelIndex = LevelIndexNumber;
-	Result.ActorName = ActorName;
-	Result.ActorIndex = ActorIndexNumber;
-	Result.ComponentNames = ComponentNames;
-	Result.ComponentIndices = ComponentIndices;
+	View.MaterializeTo(Result);
 	return true;
 }
 
-bool FPathStructure::TryParseInt(const FString& NumberString, int32& Result)
+bool FPathStructure::TryParseInt(FStringView NumberString, int32& Result)
 {
 	Result = 0;
 	for (int32 i = 0; i < NumberString.Len(); ++i)
@@ -175,3 +176,146 @@ bool FPathStructure::TryParseInt(const FString& NumberString, int32& Result)
 	}
 	return true;
 }
+
+bool FPathPatternSegment::MatchesName(FName Candidate) const
+{
+	if (Kind == EKind::Exact)
+	{
+		return Candidate == Name;
+	}
+	return MatchesName(Candidate.ToString());
+}
+
+bool FPathPatternSegment::MatchesName(const FString& Candidate) const
+{
+	switch (Kind)
+	{
+	case EKind::Exact:
+		return Name == FName(*Candidate, FNAME_Find);
+	case EKind::Prefix:
+		return Candidate.StartsWith(Pattern, ESearchCase::IgnoreCase);
+	case EKind::Wildcard:
+		return Candidate.MatchesWildcard(Pattern, ESearchCase::IgnoreCase);
+	default:
+		return true;
+	}
+}
+
+bool FPathPattern::TryParse(FStringView Pattern, FString& ErrorMessage, FPathPattern& Result)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_ParsePath);
+	Result.Components.Reset();
+	int32 WorldEnd = INDEX_NONE;
+	if (!Pattern.FindChar(TEXT('@'), WorldEnd))
+	{
+		ErrorMessage = TEXT("Missing required path components");
+		return false;
+	}
+	const int32 LevelStart = WorldEnd + 1;
+	const int32 LevelEnd = FPathStructureView::FindSeparator(Pattern, ':', '/', LevelStart);
+	if (LevelEnd == INDEX_NONE)
+	{
+		ErrorMessage = TEXT("Missing required path components");
+		return false;
+	}
+	const int32 ActorStart = LevelEnd + 2;
+	int32 ActorEnd = FPathStructureView::FindSeparator(Pattern, '-', '>', ActorStart);
+	const int32 ComponentStart = ActorEnd == INDEX_NONE ? Pattern.Len() : ActorEnd + 2;
+	if (ActorEnd == INDEX_NONE)
+	{
+		ActorEnd = Pattern.Len();
+	}
+
+	const FStringView WorldSection = Pattern.Left(WorldEnd);
+	const FStringView LevelSection = Pattern.Mid(LevelStart, LevelEnd - LevelStart);
+	const FStringView ActorSection = Pattern.Mid(ActorStart, ActorEnd - ActorStart);
+	if (WorldSection.IsEmpty() or LevelSection.IsEmpty() or ActorSection.IsEmpty())
+	{
+		ErrorMessage = TEXT("Missing required path components");
+		return false;
+	}
+	if (!TryParseSegment(WorldSection, Result.World) or Result.World.Index != INDEX_NONE)
+	{
+		ErrorMessage = FString::Printf(TEXT("Invalid world pattern: %.*s"), WorldSection.Len(), WorldSection.GetData());
+		return false;
+	}
+	if (!TryParseSegment(LevelSection, Result.Level) or Result.Level.Kind == FPathPatternSegment::EKind::AnyDepth)
+	{
+		ErrorMessage = FString::Printf(TEXT("Invalid level pattern: %.*s"), LevelSection.Len(), LevelSection.GetData());
+		return false;
+	}
+	if (!TryParseSegment(ActorSection, Result.Actor) or Result.Actor.Kind == FPathPatternSegment::EKind::AnyDepth)
+	{
+		ErrorMessage = FString::Printf(TEXT("Invalid actor pattern: %.*s"), ActorSection.Len(), ActorSection.GetData());
+		return false;
+	}
+	int32 SegmentStart = ComponentStart;
+	for (int32 i = ComponentStart; i <= Pattern.Len(); ++i)
+	{
+		if (i < Pattern.Len() and Pattern[i] != '/')
+		{
+			continue;
+		}
+		const FStringView Segment = Pattern.Mid(SegmentStart, i - SegmentStart);
+		SegmentStart = i + 1;
+		if (Segment.IsEmpty())
+		{
+			continue;
+		}
+		const bool bAfterAnyDepth = Result.Components.Num() > 0
+			and Result.Components.Last().Kind == FPathPatternSegment::EKind::AnyDepth;
+		if (bAfterAnyDepth or !TryParseSegment(Segment, Result.Components.AddDefaulted_GetRef()))
+		{
+			ErrorMessage = FString::Printf(TEXT("Invalid component pattern: %.*s"), Segment.Len(), Segment.GetData());
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FPathPattern::TryParseSegment(FStringView Section, FPathPatternSegment& Result)
+{
+	FStringView Name;
+	FStringView IndexString;
+	if (!FPathStructureView::TryParseIndexedName(Section, Name, IndexString) or Name.IsEmpty())
+	{
+		return false;
+	}
+	Result = FPathPatternSegment();
+	// Unlike exact paths, a missing index matches every index instead of the first one.
+	if (!IndexString.IsEmpty() and !(IndexString.Len() == 1 and IndexString[0] == '*')
+		and !FPathStructure::TryParseInt(IndexString, Result.Index))
+	{
+		return false;
+	}
+	if (Name.Len() == 2 and Name[0] == '*' and Name[1] == '*')
+	{
+		Result.Kind = FPathPatternSegment::EKind::AnyDepth;
+		return IndexString.IsEmpty();
+	}
+	int32 FirstWildcard = INDEX_NONE;
+	for (int32 i = 0; i < Name.Len(); ++i)
+	{
+		if (Name[i] == '*' or Name[i] == '?')
+		{
+			FirstWildcard = i;
+			break;
+		}
+	}
+	if (FirstWildcard == INDEX_NONE)
+	{
+		// Unknown names cannot match any object, and FNAME_Find leaves them as NAME_None.
+		Result.Name = FName(Name.Len(), Name.GetData(), FNAME_Find);
+	}
+	else if (FirstWildcard == Name.Len() - 1 and Name[FirstWildcard] == '*')
+	{
+		Result.Kind = FPathPatternSegment::EKind::Prefix;
+		Result.Pattern = FString(Name.Left(FirstWildcard));
+	}
+	else
+	{
+		Result.Kind = FPathPatternSegment::EKind::Wildcard;
+		Result.Pattern = FString(Name);
+	}
+	return true;
+}
@@ -1,6 +1,58 @@
 ﻿#pragma once
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
 
-struct FPathStructure
+struct FPathStructure;
+
+/**
+ * Parsed world path whose names are slices of the source string, so parsing allocates nothing.
+ * The source string must outlive the view. Use MaterializeTo when owning copies are needed.
+ */
+struct DEBUGUTILS_API FPathStructureView
+{
+	FStringView WorldName;
+	FStringView LevelName;
+	int32 LevelIndex = 0;
+	FStringView ActorName;
+	int32 ActorIndex = 0;
+	TArray<FStringView, TInlineAllocator<8>> ComponentNames;
+	TArray<int32, TInlineAllocator<8>> ComponentIndices;
+
+	static bool TryParse(FStringView Path, FString& ErrorMessage, FPathStructureView& Result);
+	void MaterializeTo(FPathStructure& Result) const;
+
+private:
+	friend struct FPathPattern;
+
+	static bool TryParseIndexedName(FStringView Section, FStringView& Name, FStringView& IndexString);
+	static int32 FindSeparator(FStringView Path, TCHAR First, TCHAR Second, int32 StartIndex);
+};
+
+/**
+ * World path with every name resolved to an FName up front, number suffix included.
+ * Matching against UObject::GetFName() is then an integer comparison, and the handle can be kept and reused across frames.
+ */
+struct DEBUGUTILS_API FCompiledPathStructure
+{
+	FName WorldName;
+	FName LevelName;
+	int32 LevelIndex = 0;
+	FName ActorName;
+	int32 ActorIndex = 0;
+	TArray<FName, TInlineAllocator<8>> ComponentNames;
+	TArray<int32, TInlineAllocator<8>> ComponentIndices;
+
+	/**
+	 * Parses and compiles a path.
+	 * @param FindType FNAME_Add keeps the handle valid for objects created later; FNAME_Find leaves unknown names as
+	 *                 NAME_None, which is enough for one-off lookups and does not grow the name table
+	 */
+	static bool TryCompile(FStringView Path, FString& ErrorMessage, FCompiledPathStructure& Result,
+	                       EFindName FindType = FNAME_Add);
+	static void Compile(const FPathStructureView& View, FCompiledPathStructure& Result, EFindName FindType = FNAME_Add);
+};
+
+struct DEBUGUTILS_API FPathStructure
 {
 	FString WorldName;
 	FString LevelName;
@@ -13,5 +65,53 @@ struct FPathStructure
 	static bool TryParse(const FString& Path, FString& ErrorMessage, FPathStructure& Result);
 
 private:
-	static bool TryParseInt(const FString& NumberString, int32& Result);
+	friend struct FPathStructureView;
+	friend struct FPathPattern;
+
+	static bool TryParseInt(FStringView NumberString, int32& Result);
+};
+
+/** One Name[Index] section of an FPathPattern. */
+struct DEBUGUTILS_API FPathPatternSegment
+{
+	enum class EKind : uint8
+	{
+		/** Plain name, matched by FName */
+		Exact,
+		/** Name ending with a single '*', matched by prefix */
+		Prefix,
+		/** Any other use of '*' or '?' */
+		Wildcard,
+		/** "**": every component below the previous segment */
+		AnyDepth
+	};
+
+	EKind Kind = EKind::Exact;
+	FName Name;
+	/** The prefix for Prefix segments, the whole pattern for Wildcard ones */
+	FString Pattern;
+	/** Same-name index to match, or INDEX_NONE to match all of them */
+	int32 Index = INDEX_NONE;
+
+	bool MatchesName(FName Candidate) const;
+	bool MatchesName(const FString& Candidate) const;
+};
+
+/**
+ * World path whose names may contain '*' and '?' wildcards, e.g. "Persistent@PersistentLevel:/BP_Enemy*->**".
+ * A section without an index, or with "[*]", matches every same-name index. A trailing "**" component segment
+ * matches every component below the previous segment, or every component of the actor when it comes first.
+ * Without any component segment the pattern matches actors.
+ */
+struct DEBUGUTILS_API FPathPattern
+{
+	FPathPatternSegment World;
+	FPathPatternSegment Level;
+	FPathPatternSegment Actor;
+	TArray<FPathPatternSegment, TInlineAllocator<8>> Components;
+
+	static bool TryParse(FStringView Pattern, FString& ErrorMessage, FPathPattern& Result);
+
+private:
+	static bool TryParseSegment(FStringView Section, FPathPatternSegment& Result);
 };
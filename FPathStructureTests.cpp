@@ -0,0 +1,57 @@
+﻿#include "FPathStructure.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPathStructureParseTest, "DebugUtils.WorldNavigator.ParsePath",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+                                 | EAutomationTestFlags::EngineFilter)
+
+bool FPathStructureParseTest::RunTest(const FString& Parameters)
+{
+	FString ErrorMessage;
+	FPathStructure Path;
+
+	// The last component segment is kept like every other one.
+	if (TestTrue(TEXT("Full path parses"),
+	             FPathStructure::TryParse(TEXT("World@Level[1]:/Actor[2]->Root[0]/Mesh[3]"), ErrorMessage, Path)))
+	{
+		TestEqual(TEXT("World"), Path.WorldName, FString(TEXT("World")));
+		TestEqual(TEXT("Level"), Path.LevelName, FString(TEXT("Level")));
+		TestEqual(TEXT("Level index"), Path.LevelIndex, 1);
+		TestEqual(TEXT("Actor"), Path.ActorName, FString(TEXT("Actor")));
+		TestEqual(TEXT("Actor index"), Path.ActorIndex, 2);
+		if (TestEqual(TEXT("Component segments"), Path.ComponentNames.Num(), 2))
+		{
+			TestEqual(TEXT("Trailing segment name"), Path.ComponentNames[1], FString(TEXT("Mesh")));
+			TestEqual(TEXT("Trailing segment index"), Path.ComponentIndices[1], 3);
+		}
+	}
+
+	// A missing index means the first object with that name.
+	if (TestTrue(TEXT("Path without indices parses"),
+	             FPathStructure::TryParse(TEXT("World@Level:/Actor->Component"), ErrorMessage, Path)))
+	{
+		TestEqual(TEXT("Missing level index"), Path.LevelIndex, 0);
+		TestEqual(TEXT("Missing actor index"), Path.ActorIndex, 0);
+		if (TestEqual(TEXT("Component segments"), Path.ComponentNames.Num(), 1))
+		{
+			TestEqual(TEXT("Missing component index"), Path.ComponentIndices[0], 0);
+		}
+	}
+
+	TestTrue(TEXT("Actor path without components parses"),
+	         FPathStructure::TryParse(TEXT("World@Level[0]:/Actor[0]"), ErrorMessage, Path)
+	         and Path.ComponentNames.Num() == 0);
+
+	TestFalse(TEXT("Non-numeric index"), FPathStructure::TryParse(TEXT("World@Level[x]:/Actor[0]"), ErrorMessage, Path));
+	TestFalse(TEXT("Unclosed index"), FPathStructure::TryParse(TEXT("World@Level[0]:/Actor[1"), ErrorMessage, Path));
+	TestFalse(TEXT("Malformed component index"),
+	          FPathStructure::TryParse(TEXT("World@Level[0]:/Actor[0]->Component[-1]"), ErrorMessage, Path));
+	TestFalse(TEXT("Missing ':/'"), FPathStructure::TryParse(TEXT("World@Level[0]Actor[0]"), ErrorMessage, Path));
+	TestFalse(TEXT("Missing '@'"), FPathStructure::TryParse(TEXT("WorldLevel[0]:/Actor[0]"), ErrorMessage, Path));
+	TestFalse(TEXT("Empty actor name"), FPathStructure::TryParse(TEXT("World@Level[0]:/"), ErrorMessage, Path));
+	return true;
+}
+
+#endif
@@ -0,0 +1,346 @@
+﻿#include "FPersistedWorldPathIndex.h"
+#include "UWorldNavigator.h"
+#include "DebugUtilsStats.h"
+#include "Async/MappedFileHandle.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformFileManager.h"
+#include "IO/IoHash.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Crc.h"
+#include "Misc/EngineVersionComparison.h"
+#include "UObject/Package.h"
+
+struct FPersistedWorldPathIndex::FHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x49505544; // "DUPI"
+	static constexpr uint32 ExpectedVersion = 2;
+
+	uint32 Magic;
+	uint32 Version;
+	uint64 FileSize;
+	uint32 NumLevels;
+	uint32 Padding;
+	uint64 LevelsOffset;
+};
+
+struct FPersistedWorldPathIndex::FLevelRecord
+{
+	uint32 NameHash;
+	int32 SameNameIndex;
+	int32 NumActors;
+	uint32 Padding;
+	FGuid Fingerprint;
+	uint64 SlotsOffset;
+	/** Open addressing table of the level's actors; always a power of two */
+	uint32 NumSlots;
+	uint32 Padding2;
+};
+
+struct FPersistedWorldPathIndex::FActorSlot
+{
+	uint32 NameHash;
+	int32 SameNameIndex;
+	/** Index into ULevel::Actors, or INDEX_NONE for an empty slot */
+	int32 Position;
+	/** Actors of the level sharing the name; above one, the live same-name index is checked on every hit */
+	int32 NumSameName;
+};
+
+static_assert(sizeof(FGuid) == 16, "The persisted index stores FGuid as 16 raw bytes");
+
+namespace
+{
+	template <typename T>
+	uint64 AppendRecord(TArray<uint8>& Bytes, const T& Record)
+	{
+		const uint64 Offset = Bytes.Num();
+		Bytes.Append(reinterpret_cast<const uint8*>(&Record), sizeof(T));
+		return Offset;
+	}
+
+	void AlignTo(TArray<uint8>& Bytes, int32 Alignment)
+	{
+		Bytes.AddZeroed(Align(Bytes.Num(), Alignment) - Bytes.Num());
+	}
+}
+
+bool FPersistedWorldPathIndex::Save(UWorld* World, const FString& FilePath)
+{
+	if (World == nullptr)
+	{
+		return false;
+	}
+	TArray<ULevel*> Levels;
+	for (const auto Level : UWorldNavigator::GetAllLevelsInWorld(World))
+	{
+		if (Level != nullptr)
+		{
+			Levels.Add(Level);
+		}
+	}
+	TArray<uint8> Bytes;
+	FHeader Header = {};
+	Header.Magic = FHeader::ExpectedMagic;
+	Header.Version = FHeader::ExpectedVersion;
+	Header.NumLevels = Levels.Num();
+	AppendRecord(Bytes, Header);
+	AlignTo(Bytes, 8);
+	Header.LevelsOffset = Bytes.Num();
+	Bytes.AddZeroed(Levels.Num() * sizeof(FLevelRecord));
+
+	TArray<FLevelRecord> Records;
+	for (const auto Level : Levels)
+	{
+		FLevelRecord& Record = Records.AddZeroed_GetRef();
+		Record.NameHash = HashName(Level->GetFName());
+		Record.SameNameIndex = UWorldNavigator::GetIndexOfSameLevel(Level);
+		Record.NumActors = Level->Actors.Num();
+		Record.Fingerprint = GetLevelFingerprint(Level);
+		Record.NumSlots = FMath::RoundUpToPowerOfTwo(FMath::Max(4, Level->Actors.Num() * 2));
+		TArray<FActorSlot> Slots;
+		Slots.Init(FActorSlot{0, 0, INDEX_NONE, 0}, Record.NumSlots);
+		TMap<FName, int32> NameCounts;
+		for (const AActor* Actor : Level->Actors)
+		{
+			if (Actor != nullptr)
+			{
+				++NameCounts.FindOrAdd(Actor->GetFName());
+			}
+		}
+		TMap<FName, int32> SameNameCounts;
+		for (int32 Position = 0; Position < Level->Actors.Num(); ++Position)
+		{
+			const AActor* Actor = Level->Actors[Position];
+			if (Actor == nullptr)
+			{
+				continue;
+			}
+			int32& SameNameIndex = SameNameCounts.FindOrAdd(Actor->GetFName());
+			const uint32 Hash = HashName(Actor->GetFName());
+			uint32 Slot = Hash & (Record.NumSlots - 1);
+			while (Slots[Slot].Position != INDEX_NONE)
+			{
+				Slot = (Slot + 1) & (Record.NumSlots - 1);
+			}
+			Slots[Slot] = FActorSlot{Hash, SameNameIndex++, Position, NameCounts[Actor->GetFName()]};
+		}
+		AlignTo(Bytes, 8);
+		Record.SlotsOffset = Bytes.Num();
+		Bytes.Append(reinterpret_cast<const uint8*>(Slots.GetData()), Slots.Num() * sizeof(FActorSlot));
+	}
+	FMemory::Memcpy(Bytes.GetData() + Header.LevelsOffset, Records.GetData(), Records.Num() * sizeof(FLevelRecord));
+	Header.FileSize = Bytes.Num();
+	FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(Header));
+	return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+}
+
+TUniquePtr<FPersistedWorldPathIndex> FPersistedWorldPathIndex::Load(const FString& FilePath)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_ResolvePath);
+	TUniquePtr<FPersistedWorldPathIndex> Index(new FPersistedWorldPathIndex());
+	Index->MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if (Index->MappedFile.IsValid())
+	{
+		Index->MappedRegion.Reset(Index->MappedFile->MapRegion(0, Index->MappedFile->GetFileSize()));
+	}
+	if (Index->MappedRegion.IsValid())
+	{
+		Index->Data = Index->MappedRegion->GetMappedPtr();
+		Index->Size = Index->MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Platforms without file mapping read the file once instead.
+		Index->MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(Index->LoadedBytes, *FilePath, FILEREAD_Silent))
+		{
+			return nullptr;
+		}
+		Index->Data = Index->LoadedBytes.GetData();
+		Index->Size = Index->LoadedBytes.Num();
+	}
+	if (!Index->Validate())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ignoring invalid path index file %s"), *FilePath);
+		return nullptr;
+	}
+	return Index;
+}
+
+FPersistedWorldPathIndex::~FPersistedWorldPathIndex()
+{
+	// The region has to be unmapped before the file it belongs to is closed.
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+int32 FPersistedWorldPathIndex::Bind(UWorld* World)
+{
+	BoundLevels.Reset();
+	if (World == nullptr)
+	{
+		return 0;
+	}
+	const FLevelRecord* Records = GetLevels();
+	for (const auto Level : UWorldNavigator::GetAllLevelsInWorld(World))
+	{
+		if (Level == nullptr or BoundLevels.Contains(Level))
+		{
+			continue;
+		}
+		const uint32 NameHash = HashName(Level->GetFName());
+		const int32 SameNameIndex = UWorldNavigator::GetIndexOfSameLevel(Level);
+		const FGuid Fingerprint = GetLevelFingerprint(Level);
+		for (uint32 i = 0; i < GetHeader().NumLevels; ++i)
+		{
+			const FLevelRecord& Record = Records[i];
+			if (Record.NameHash == NameHash and Record.SameNameIndex == SameNameIndex
+				and Record.Fingerprint == Fingerprint and Record.NumActors == Level->Actors.Num())
+			{
+				BoundLevels.Add(Level, i);
+				break;
+			}
+		}
+	}
+	return BoundLevels.Num();
+}
+
+void FPersistedWorldPathIndex::Unbind(const ULevel* Level)
+{
+	BoundLevels.Remove(Level);
+}
+
+bool FPersistedWorldPathIndex::IsBound(const ULevel* Level) const
+{
+	return BoundLevels.Contains(Level);
+}
+
+AActor* FPersistedWorldPathIndex::FindActor(ULevel* Level, FName ActorName, int32 ActorIndex) const
+{
+	const int32* RecordIndex = BoundLevels.Find(Level);
+	if (RecordIndex == nullptr)
+	{
+		return nullptr;
+	}
+	const FLevelRecord& Record = GetLevels()[*RecordIndex];
+	const FActorSlot* Slots = GetSlots(Record);
+	const uint32 Hash = HashName(ActorName);
+	const uint32 Mask = Record.NumSlots - 1;
+	for (uint32 Probe = 0, Slot = Hash & Mask; Probe < Record.NumSlots; ++Probe, Slot = (Slot + 1) & Mask)
+	{
+		const FActorSlot& Entry = Slots[Slot];
+		if (Entry.Position == INDEX_NONE)
+		{
+			return nullptr;
+		}
+		if (Entry.NameHash != Hash or Entry.SameNameIndex != ActorIndex or !Level->Actors.IsValidIndex(Entry.Position))
+		{
+			continue;
+		}
+		// Hash collisions and actors renamed since the save are caught by comparing the live name.
+		AActor* Actor = Level->Actors[Entry.Position];
+		if (Actor == nullptr or Actor->GetFName() != ActorName)
+		{
+			continue;
+		}
+		// Actors sharing a name can have been loaded in another order, which swaps their same-name indices.
+		if (Entry.NumSameName > 1 and GetLiveSameNameIndex(Level, Entry.Position) != ActorIndex)
+		{
+			return nullptr;
+		}
+		return Actor;
+	}
+	return nullptr;
+}
+
+int32 FPersistedWorldPathIndex::GetLiveSameNameIndex(const ULevel* Level, int32 Position)
+{
+	const FName Name = Level->Actors[Position]->GetFName();
+	int32 SameNameIndex = 0;
+	for (int32 i = 0; i < Position; ++i)
+	{
+		if (Level->Actors[i] != nullptr and Level->Actors[i]->GetFName() == Name)
+		{
+			++SameNameIndex;
+		}
+	}
+	return SameNameIndex;
+}
+
+bool FPersistedWorldPathIndex::Validate() const
+{
+	if (Data == nullptr or Size < static_cast<int64>(sizeof(FHeader)))
+	{
+		return false;
+	}
+	const FHeader& Header = GetHeader();
+	if (Header.Magic != FHeader::ExpectedMagic or Header.Version != FHeader::ExpectedVersion
+		or Header.FileSize != static_cast<uint64>(Size))
+	{
+		return false;
+	}
+	const uint64 FileSize = Header.FileSize;
+	if (Header.LevelsOffset > FileSize
+		or Header.NumLevels > (FileSize - Header.LevelsOffset) / sizeof(FLevelRecord)
+		or Header.LevelsOffset % alignof(FLevelRecord) != 0)
+	{
+		return false;
+	}
+	const FLevelRecord* Records = GetLevels();
+	for (uint32 i = 0; i < Header.NumLevels; ++i)
+	{
+		const FLevelRecord& Record = Records[i];
+		if (!FMath::IsPowerOfTwo(Record.NumSlots) or Record.SlotsOffset > FileSize
+			or Record.NumSlots > (FileSize - Record.SlotsOffset) / sizeof(FActorSlot)
+			or Record.SlotsOffset % alignof(FActorSlot) != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+const FPersistedWorldPathIndex::FHeader& FPersistedWorldPathIndex::GetHeader() const
+{
+	return *reinterpret_cast<const FHeader*>(Data);
+}
+
+const FPersistedWorldPathIndex::FLevelRecord* FPersistedWorldPathIndex::GetLevels() const
+{
+	return reinterpret_cast<const FLevelRecord*>(Data + GetHeader().LevelsOffset);
+}
+
+const FPersistedWorldPathIndex::FActorSlot* FPersistedWorldPathIndex::GetSlots(const FLevelRecord& Level) const
+{
+	return reinterpret_cast<const FActorSlot*>(Data + Level.SlotsOffset);
+}
+
+uint32 FPersistedWorldPathIndex::HashName(FName Name)
+{
+	// FName indices differ between sessions, so the file hashes the text, lowercased because FName ignores case.
+	TStringBuilder<NAME_SIZE> Builder;
+	Name.AppendString(Builder);
+	TCHAR* const Chars = Builder.GetData();
+	for (int32 i = 0; i < Builder.Len(); ++i)
+	{
+		Chars[i] = FChar::ToLower(Chars[i]);
+	}
+	return FCrc::StrCrc32(Builder.ToString());
+}
+
+FGuid FPersistedWorldPathIndex::GetLevelFingerprint(const ULevel* Level)
+{
+	// UPackage::GetPersistentGuid keeps the identity of the package across saves, so it cannot tell an edited map.
+#if WITH_EDITORONLY_DATA && !UE_VERSION_OLDER_THAN(5, 1, 0)
+	// The saved hash changes whenever the map is saved. Its first 16 bytes are plenty to tell two saves apart.
+	const FIoHash SavedHash = Level->GetOutermost()->GetSavedHash();
+	FGuid Fingerprint;
+	static_assert(sizeof(FIoHash) >= sizeof(FGuid), "The fingerprint is a prefix of the saved hash");
+	FMemory::Memcpy(&Fingerprint, SavedHash.GetBytes(), sizeof(Fingerprint));
+	return Fingerprint;
+#else
+	return Level->LevelBuildDataId;
+#endif
+}
@@ -0,0 +1,64 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class AActor;
+class IMappedFileHandle;
+class IMappedFileRegion;
+class ULevel;
+class UWorld;
+
+/**
+ * A world's level and actor lookup tables saved to a flat file that is used in place, memory-mapped, without any
+ * parsing or fix-ups: every record is plain data and every reference is a file offset. Attached to an
+ * FWorldPathIndex, it answers actor lookups at startup before any level table has been built.
+ *
+ * Levels are validated when the file is bound to a world, against their package's saved hash in editor builds on
+ * 5.1 and later or their LevelBuildDataId otherwise, plus their actor count. Every hit is also checked against the live actor's name and,
+ * for names several actors share, its live same-name index, as such actors can load in another order. Stale entries
+ * therefore only cause a miss. Levels that fail validation, or that change afterwards, are built as usual.
+ * Components are not stored: their order depends on UObject unique ids, which differ between sessions, and
+ * per-actor tables are cheap to build on first use.
+ */
+class DEBUGUTILS_API FPersistedWorldPathIndex
+{
+public:
+	/** Writes the lookup tables of every level of the world to FilePath. */
+	static bool Save(UWorld* World, const FString& FilePath);
+	/** Maps the file and checks its header and table bounds. @return nullptr if the file is missing or invalid */
+	static TUniquePtr<FPersistedWorldPathIndex> Load(const FString& FilePath);
+
+	~FPersistedWorldPathIndex();
+
+	/** Matches the stored levels to the world's levels. @return The number of levels that passed validation */
+	int32 Bind(UWorld* World);
+	/** Stops answering for the level, e.g. after actors were destroyed and the same-name indices shifted. */
+	void Unbind(const ULevel* Level);
+	bool IsBound(const ULevel* Level) const;
+	/** @return The actor stored for the name and index if the level is bound and the actor is still there */
+	AActor* FindActor(ULevel* Level, FName ActorName, int32 ActorIndex) const;
+
+private:
+	struct FHeader;
+	struct FLevelRecord;
+	struct FActorSlot;
+
+	FPersistedWorldPathIndex() = default;
+
+	bool Validate() const;
+	const FHeader& GetHeader() const;
+	const FLevelRecord* GetLevels() const;
+	const FActorSlot* GetSlots(const FLevelRecord& Level) const;
+	static uint32 HashName(FName Name);
+	/** @return The same-name index of the actor at Position, counted in the live level */
+	static int32 GetLiveSameNameIndex(const ULevel* Level, int32 Position);
+	static FGuid GetLevelFingerprint(const ULevel* Level);
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	/** File contents when the platform cannot map files */
+	TArray<uint8> LoadedBytes;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+	TMap<TObjectKey<ULevel>, int32> BoundLevels;
+};
@@ -0,0 +1,39 @@
+﻿#include "FReprDiffer.h"
+
+FReprDiffer& FReprDiffer::Get()
+{
+	static FReprDiffer Differ;
+	return Differ;
+}
+
+void FReprDiffer::Reset(FName Id)
+{
+	States.Remove(Id);
+}
+
+void FReprDiffer::ResetAll()
+{
+	States.Reset();
+}
+
+bool FReprDiffer::BeginChange(FStringBuilderBase& Builder, TCHAR Change, int32 ChangeIndex,
+                              const FReprOptions& Options, bool& bTruncated)
+{
+	if (bTruncated)
+	{
+		return false;
+	}
+	if (ChangeIndex > 0)
+	{
+		Builder << TEXT(", ");
+	}
+	if (Options.IsExhausted(Builder, ChangeIndex))
+	{
+		// The callers leave the state of the changes that are not printed untouched, so they are reported again.
+		Builder << TEXT("...");
+		bTruncated = true;
+		return false;
+	}
+	Builder << Change;
+	return true;
+}
@@ -0,0 +1,342 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "Hash/CityHash.h"
+#include "Templates/Models.h"
+#include "URepr.h"
+#include <type_traits>
+
+namespace ReprDifferPrivate
+{
+	/**
+	 * Types whose bytes fully determine their Repr, so hashing the memory is enough to detect a change. Pointers and
+	 * USTRUCTs are excluded: the Repr of a UObject pointer, also one held by a USTRUCT field, depends on the
+	 * object's properties rather than on its address. FVector, FRotator and FQuat opt back in below.
+	 */
+	template <typename T>
+	struct THashesRawBytes
+		: std::bool_constant<std::is_arithmetic_v<T>
+			or (std::has_unique_object_representations_v<T> and !std::is_pointer_v<T> and !TIsReprReflected<T>::value)>
+	{
+	};
+
+	template <>
+	struct THashesRawBytes<FVector> : std::true_type
+	{
+	};
+
+	template <>
+	struct THashesRawBytes<FRotator> : std::true_type
+	{
+	};
+
+	template <>
+	struct THashesRawBytes<FQuat> : std::true_type
+	{
+	};
+
+	inline uint64 CombineHash(uint64 Seed, uint64 Hash)
+	{
+		return CityHash64WithSeed(reinterpret_cast<const char*>(&Hash), sizeof(Hash), Seed);
+	}
+
+	template <typename T>
+	uint64 HashValue(const T& Value);
+	template <typename K, typename V>
+	uint64 HashValue(const TPair<K, V>& Pair);
+	template <typename T>
+	uint64 HashValue(const TArray<T>& Array);
+	template <typename T>
+	uint64 HashValue(const TSet<T>& Set);
+	template <typename K, typename V>
+	uint64 HashValue(const TMap<K, V>& Map);
+	template <typename T>
+	uint64 HashValue(const TOptional<T>& Optional);
+
+	/**
+	 * 64-bit hash of the state that determines Repr(Value), computed without formatting it: bytes for plain data,
+	 * characters for strings, the cached reflection plan for USTRUCTs and UObjects, element by element for
+	 * containers and GetTypeHash for anything else.
+	 */
+	template <typename T>
+	uint64 HashValue(const T& Value)
+	{
+		if constexpr (TIsReprObjectPointer<T>::value)
+		{
+			return FReprReflection::HashObject(Value);
+		}
+		else if constexpr (THashesRawBytes<T>::value)
+		{
+			return CityHash64(reinterpret_cast<const char*>(&Value), sizeof(T));
+		}
+		else if constexpr (std::is_same_v<T, FString>)
+		{
+			return CityHash64(reinterpret_cast<const char*>(*Value), Value.Len() * sizeof(TCHAR));
+		}
+		else if constexpr (std::is_same_v<T, FText>)
+		{
+			return HashValue(Value.ToString());
+		}
+		else if constexpr (TIsReprReflected<T>::value)
+		{
+			return FReprReflection::HashStruct(TBaseStructure<T>::Get(), &Value);
+		}
+		else
+		{
+			static_assert(TModels<CGetTypeHashable, T>::Value,
+				"FReprDiffer hashes USTRUCTs, UObjects, containers and types with GetTypeHash; add a GetTypeHash overload for this type");
+			return GetTypeHash(Value);
+		}
+	}
+
+	template <typename K, typename V>
+	uint64 HashValue(const TPair<K, V>& Pair)
+	{
+		return CombineHash(HashValue(Pair.Key), HashValue(Pair.Value));
+	}
+
+	template <typename T>
+	uint64 HashValue(const TArray<T>& Array)
+	{
+		uint64 Hash = Array.Num();
+		for (const T& Element : Array)
+		{
+			Hash = CombineHash(Hash, HashValue(Element));
+		}
+		return Hash;
+	}
+
+	template <typename T>
+	uint64 HashValue(const TSet<T>& Set)
+	{
+		uint64 Hash = Set.Num();
+		for (const T& Element : Set)
+		{
+			Hash = CombineHash(Hash, HashValue(Element));
+		}
+		return Hash;
+	}
+
+	template <typename K, typename V>
+	uint64 HashValue(const TMap<K, V>& Map)
+	{
+		uint64 Hash = Map.Num();
+		for (const auto& Pair : Map)
+		{
+			Hash = CombineHash(Hash, HashValue(Pair));
+		}
+		return Hash;
+	}
+
+	template <typename T>
+	uint64 HashValue(const TOptional<T>& Optional)
+	{
+		return Optional.IsSet() ? CombineHash(1, HashValue(Optional.GetValue())) : 0;
+	}
+}
+
+/**
+ * Formats only what changed in a container since the previous call with the same id.
+ * The differ keeps a 64-bit hash per element instead of the previous text, so each call hashes every element but
+ * only formats the added ("+"), changed ("~") and removed ("-") ones, which keeps the output and the formatting cost
+ * proportional to the amount of change. The first call for an id reports every element as added.
+ * Not thread-safe: use Get() from the game thread only, or one differ per thread.
+ */
+class DEBUGUTILS_API FReprDiffer
+{
+public:
+	static FReprDiffer& Get();
+
+	/**
+	 * Appends "{+Key: Value, ~Key: Value, -Key}" for the entries of Map that changed since the last call for Id.
+	 * Options.MaxElements and MaxOutputLength bound the number of printed changes, not the comparison. Changes that
+	 * are not printed are not recorded either, so the next call reports them again.
+	 * @return Whether anything changed
+	 */
+	template <typename K, typename V>
+	bool DiffTo(FStringBuilderBase& Builder, FName Id, const TMap<K, V>& Map, const FReprOptions& Options = FReprOptions())
+	{
+		TMapState<K>& State = FindOrAddState<TMapState<K>>(Id, GetStateType<TMap<K, V>>());
+		const uint32 Epoch = ++State.Epoch;
+		const FReprOptions ElementOptions = Options.Descend();
+		int32 NumChanges = 0;
+		bool bTruncated = false;
+		Builder << TEXT('{');
+		for (const auto& Pair : Map)
+		{
+			const uint64 Hash = ReprDifferPrivate::HashValue(Pair.Value);
+			FEntry* Entry = State.Entries.Find(Pair.Key);
+			if (Entry != nullptr)
+			{
+				Entry->Epoch = Epoch;
+				if (Entry->Hash == Hash)
+				{
+					continue;
+				}
+			}
+			if (!BeginChange(Builder, Entry != nullptr ? TEXT('~') : TEXT('+'), NumChanges++, Options, bTruncated))
+			{
+				continue;
+			}
+			ReprTo(Builder, Pair.Key, ElementOptions);
+			Builder << TEXT(": ");
+			ReprTo(Builder, Pair.Value, ElementOptions);
+			if (Entry != nullptr)
+			{
+				Entry->Hash = Hash;
+			}
+			else
+			{
+				State.Entries.Add(Pair.Key, FEntry{Hash, Epoch});
+			}
+		}
+		for (auto It = State.Entries.CreateIterator(); It; ++It)
+		{
+			if (It->Value.Epoch != Epoch and BeginChange(Builder, TEXT('-'), NumChanges++, Options, bTruncated))
+			{
+				ReprTo(Builder, It->Key, ElementOptions);
+				It.RemoveCurrent();
+			}
+		}
+		Builder << TEXT('}');
+		return NumChanges > 0;
+	}
+
+	/**
+	 * Appends "[~Index: Value, +Index: Value, -Index]" for the elements of Array that changed since the last call
+	 * for Id. Elements are matched by index, so an insertion reports every later element as changed. As for maps,
+	 * changes cut off by the options are reported again by the next call.
+	 * @return Whether anything changed
+	 */
+	template <typename T>
+	bool DiffTo(FStringBuilderBase& Builder, FName Id, const TArray<T>& Array, const FReprOptions& Options = FReprOptions())
+	{
+		FArrayState& State = FindOrAddState<FArrayState>(Id, GetStateType<TArray<T>>());
+		const FReprOptions ElementOptions = Options.Descend();
+		const int32 NumPrevious = State.Hashes.Num();
+		int32 NumChanges = 0;
+		bool bTruncated = false;
+		Builder << TEXT('[');
+		for (int32 i = 0; i < Array.Num(); ++i)
+		{
+			// Real hashes are kept off RemovedHash, which marks the indices already reported as removed.
+			const uint64 Hash = FMath::Min(ReprDifferPrivate::HashValue(Array[i]), RemovedHash - 1);
+			const bool bKnown = i < NumPrevious and State.Hashes[i] != RemovedHash;
+			if (bKnown and State.Hashes[i] == Hash)
+			{
+				continue;
+			}
+			if (!BeginChange(Builder, bKnown ? TEXT('~') : TEXT('+'), NumChanges++, Options, bTruncated))
+			{
+				continue;
+			}
+			Builder << i << TEXT(": ");
+			ReprTo(Builder, Array[i], ElementOptions);
+			// Printed changes always precede the truncated ones, so the printed additions are appended in order.
+			if (i < NumPrevious)
+			{
+				State.Hashes[i] = Hash;
+			}
+			else
+			{
+				State.Hashes.Add(Hash);
+			}
+		}
+		for (int32 i = Array.Num(); i < NumPrevious; ++i)
+		{
+			if (State.Hashes[i] != RemovedHash and BeginChange(Builder, TEXT('-'), NumChanges++, Options, bTruncated))
+			{
+				Builder << i;
+				State.Hashes[i] = RemovedHash;
+			}
+		}
+		while (State.Hashes.Num() > 0 and State.Hashes.Last() == RemovedHash)
+		{
+			State.Hashes.Pop(EAllowShrinking::No);
+		}
+		Builder << TEXT(']');
+		return NumChanges > 0;
+	}
+
+	template <typename ContainerType>
+	FString Diff(FName Id, const ContainerType& Container, const FReprOptions& Options = FReprOptions())
+	{
+		TStringBuilder<256> Builder;
+		DiffTo(Builder, Id, Container, Options);
+		return FString(Builder.Len(), Builder.GetData());
+	}
+
+	/** Forgets the previous state of Id, so its next diff reports every element as added. */
+	void Reset(FName Id);
+	void ResetAll();
+
+private:
+	struct FEntry
+	{
+		uint64 Hash = 0;
+		uint32 Epoch = 0;
+	};
+
+	struct FState
+	{
+		virtual ~FState() = default;
+
+		/** Identifies the container type the state was built for */
+		const void* Type = nullptr;
+	};
+
+	template <typename K>
+	struct TMapState final : FState
+	{
+		TMap<K, FEntry> Entries;
+		/** Bumped per diff; entries not stamped with the current epoch were removed from the map. */
+		uint32 Epoch = 0;
+	};
+
+	struct FArrayState final : FState
+	{
+		/** Per index, the hash last reported, or RemovedHash once the index was reported as removed */
+		TArray<uint64> Hashes;
+	};
+
+	static constexpr uint64 RemovedHash = MAX_uint64;
+
+	/** @return A unique address per container type, so reusing an id for another type starts over instead of misreading state */
+	template <typename ContainerType>
+	static const void* GetStateType()
+	{
+		static const uint8 Type = 0;
+		return &Type;
+	}
+
+	template <typename StateType>
+	StateType& FindOrAddState(FName Id, const void* Type)
+	{
+		TUniquePtr<FState>& State = States.FindOrAdd(Id);
+		if (!State.IsValid() or State->Type != Type)
+		{
+			State = MakeUnique<StateType>();
+			State->Type = Type;
+		}
+		return static_cast<StateType&>(*State);
+	}
+
+	/**
+	 * Writes the separator and the change marker, or a single "..." once the options are exhausted.
+	 * @return Whether the change should be printed
+	 */
+	static bool BeginChange(FStringBuilderBase& Builder, TCHAR Change, int32 ChangeIndex, const FReprOptions& Options,
+	                        bool& bTruncated);
+
+	TMap<FName, TUniquePtr<FState>> States;
+};
+
+/** Logs only the entries of x that changed since the last UE_REPR_DIFF with the same id, and nothing if none did. */
+#define UE_REPR_DIFF(Id, x) \
+	do \
+	{ \
+		TStringBuilder<256> ReprDiffBuilder; \
+		if (FReprDiffer::Get().DiffTo(ReprDiffBuilder, Id, x)) \
+		{ \
+			UE_LOG(LogTemp, Display, TEXT("%s = %s"), TEXT(#x), ReprDiffBuilder.ToString()); \
+		} \
+	} while (false)
@@ -0,0 +1,69 @@
+﻿#include "FReprDiffer.h"
+#include "Components/SceneComponent.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReprDifferObjectChangeTest, "DebugUtils.Repr.Differ.ObjectPropertyChange",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+                                 | EAutomationTestFlags::EngineFilter)
+
+bool FReprDifferObjectChangeTest::RunTest(const FString& Parameters)
+{
+	// Objects are hashed through their properties, so a change to the object behind an unchanged pointer is reported.
+	USceneComponent* Component = NewObject<USceneComponent>();
+	TMap<int32, USceneComponent*> Components;
+	Components.Add(1, Component);
+	FReprDiffer Differ;
+	TestTrue(TEXT("First diff reports the entry as added"),
+	         Differ.Diff(TEXT("Components"), Components).StartsWith(TEXT("{+1_i32: ")));
+	TestEqual(TEXT("Unchanged object"), Differ.Diff(TEXT("Components"), Components), FString(TEXT("{}")));
+
+	Component->SetRelativeLocation_Direct(FVector(1.0, 2.0, 3.0));
+	TestTrue(TEXT("Changed property is reported"),
+	         Differ.Diff(TEXT("Components"), Components).StartsWith(TEXT("{~1_i32: ")));
+	TestEqual(TEXT("Change is reported once"), Differ.Diff(TEXT("Components"), Components), FString(TEXT("{}")));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReprDifferTruncationTest, "DebugUtils.Repr.Differ.TruncatedChanges",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+                                 | EAutomationTestFlags::EngineFilter)
+
+bool FReprDifferTruncationTest::RunTest(const FString& Parameters)
+{
+	// Changes cut off by the options are not recorded, so each call reports the next one until none are left.
+	FReprOptions Options;
+	Options.MaxElements = 1;
+	FReprDiffer Differ;
+
+	TMap<int32, int32> Map;
+	Map.Add(1, 10);
+	Map.Add(2, 20);
+	TestEqual(TEXT("First added entry"), Differ.Diff(TEXT("Map"), Map, Options), FString(TEXT("{+1_i32: 10_i32, ...}")));
+	TestEqual(TEXT("Truncated added entry"), Differ.Diff(TEXT("Map"), Map, Options), FString(TEXT("{+2_i32: 20_i32}")));
+	TestEqual(TEXT("Map up to date"), Differ.Diff(TEXT("Map"), Map, Options), FString(TEXT("{}")));
+	Map.Reset();
+	TestEqual(TEXT("First removed entry"), Differ.Diff(TEXT("Map"), Map, Options), FString(TEXT("{-1_i32, ...}")));
+	TestEqual(TEXT("Truncated removed entry"), Differ.Diff(TEXT("Map"), Map, Options), FString(TEXT("{-2_i32}")));
+	TestEqual(TEXT("Map emptied"), Differ.Diff(TEXT("Map"), Map, Options), FString(TEXT("{}")));
+
+	TArray<int32> Array = {1, 2, 3};
+	TestEqual(TEXT("First added element"), Differ.Diff(TEXT("Array"), Array, Options), FString(TEXT("[+0: 1_i32, ...]")));
+	TestEqual(TEXT("Second added element"), Differ.Diff(TEXT("Array"), Array, Options), FString(TEXT("[+1: 2_i32, ...]")));
+	Array[0] = 4;
+	TestEqual(TEXT("Changed element before a truncated addition"), Differ.Diff(TEXT("Array"), Array, Options),
+	          FString(TEXT("[~0: 4_i32, ...]")));
+	TestEqual(TEXT("Last added element"), Differ.Diff(TEXT("Array"), Array, Options), FString(TEXT("[+2: 3_i32]")));
+	Array.Reset();
+	TestEqual(TEXT("First removed element"), Differ.Diff(TEXT("Array"), Array, Options), FString(TEXT("[-0, ...]")));
+	Array.Add(5);
+	TestEqual(TEXT("Index reused after its removal"), Differ.Diff(TEXT("Array"), Array, Options),
+	          FString(TEXT("[+0: 5_i32, ...]")));
+	TestEqual(TEXT("Remaining removed elements"), Differ.Diff(TEXT("Array"), Array, Options), FString(TEXT("[-1, ...]")));
+	TestEqual(TEXT("Last removed element"), Differ.Diff(TEXT("Array"), Array, Options), FString(TEXT("[-2]")));
+	TestEqual(TEXT("Array up to date"), Differ.Diff(TEXT("Array"), Array, Options), FString(TEXT("[]")));
+	return true;
+}
+
+#endif
@@ -0,0 +1,266 @@
+﻿#include "FReprLogSink.h"
+#include "Containers/Queue.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
+#include <atomic>
+
+namespace
+{
+	int64 GetQueuedSize(int32 Length)
+	{
+		return static_cast<int64>(Length) * sizeof(TCHAR) + sizeof(FString);
+	}
+}
+
+class FReprLogSink::FWriter final : public FRunnable
+{
+public:
+	explicit FWriter(FReprLogSinkSettings InSettings)
+		: Settings(MoveTemp(InSettings))
+	{
+		if (!Settings.Output and !Settings.FilePath.IsEmpty())
+		{
+			File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Settings.FilePath, true, true));
+			if (!File.IsValid())
+			{
+				UE_LOG(LogTemp, Error, TEXT("FReprLogSink could not open %s"), *Settings.FilePath);
+			}
+		}
+		WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+		SpaceEvent = FPlatformProcess::GetSynchEventFromPool(false);
+		Thread = FRunnableThread::Create(this, TEXT("ReprLogSinkWriter"), 0, TPri_BelowNormal);
+	}
+
+	virtual ~FWriter() override
+	{
+		bStopping = true;
+		WorkEvent->Trigger();
+		if (Thread != nullptr)
+		{
+			Thread->WaitForCompletion();
+			delete Thread;
+		}
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		FPlatformProcess::ReturnSynchEventToPool(SpaceEvent);
+	}
+
+	void Enqueue(FStringView Line)
+	{
+		const int64 Size = GetQueuedSize(Line.Len());
+		if (QueuedBytes.load(std::memory_order_relaxed) + Size > Settings.MaxQueuedBytes)
+		{
+			switch (Settings.OverflowPolicy)
+			{
+			case EReprLogOverflowPolicy::DropNewest:
+				NumDropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			case EReprLogOverflowPolicy::DropOldest:
+				{
+					// Dequeuing here is safe because every consumer holds ConsumerLock.
+					FScopeLock Lock(&ConsumerLock);
+					FString Oldest;
+					while (QueuedBytes.load(std::memory_order_relaxed) + Size > Settings.MaxQueuedBytes
+						and Lines.Dequeue(Oldest))
+					{
+						QueuedBytes.fetch_sub(GetQueuedSize(Oldest.Len()), std::memory_order_relaxed);
+						NumDropped.fetch_add(1, std::memory_order_relaxed);
+						NumProcessed.fetch_add(1, std::memory_order_release);
+					}
+					break;
+				}
+			case EReprLogOverflowPolicy::Block:
+				// Output logging to the sink from the writer thread would wait for itself to make room.
+				if (FPlatformTLS::GetCurrentThreadId() == WriterThreadId.load(std::memory_order_relaxed))
+				{
+					NumDropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				// A single line larger than the budget is let through once the queue is empty.
+				while (QueuedBytes.load(std::memory_order_relaxed) > 0
+					and QueuedBytes.load(std::memory_order_relaxed) + Size > Settings.MaxQueuedBytes and !bStopping)
+				{
+					WorkEvent->Trigger();
+					SpaceEvent->Wait(1);
+				}
+				break;
+			}
+		}
+		QueuedBytes.fetch_add(Size, std::memory_order_relaxed);
+		NumEnqueued.fetch_add(1, std::memory_order_relaxed);
+		Lines.Enqueue(FString(Line));
+		if (QueuedBytes.load(std::memory_order_relaxed) * 2 > Settings.MaxQueuedBytes)
+		{
+			WorkEvent->Trigger();
+		}
+	}
+
+	void Flush()
+	{
+		const int64 Target = NumEnqueued.load(std::memory_order_relaxed);
+		while (NumProcessed.load(std::memory_order_acquire) < Target)
+		{
+			WorkEvent->Trigger();
+			FPlatformProcess::Sleep(0.001f);
+		}
+	}
+
+	int64 GetNumDropped() const
+	{
+		return NumDropped.load(std::memory_order_relaxed);
+	}
+
+	virtual uint32 Run() override
+	{
+		WriterThreadId.store(FPlatformTLS::GetCurrentThreadId(), std::memory_order_relaxed);
+		const uint32 WaitMilliseconds = FMath::Max(1, FMath::RoundToInt(Settings.FlushIntervalSeconds * 1000.0f));
+		while (!bStopping)
+		{
+			WorkEvent->Wait(WaitMilliseconds);
+			WriteQueuedLines();
+		}
+		WriteQueuedLines();
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopping = true;
+		WorkEvent->Trigger();
+	}
+
+private:
+	void WriteQueuedLines()
+	{
+		TArray<FString> Batch;
+		Batch.Reserve(Settings.MaxBatchSize);
+		while (true)
+		{
+			{
+				FScopeLock Lock(&ConsumerLock);
+				FString Line;
+				while (Batch.Num() < Settings.MaxBatchSize and Lines.Dequeue(Line))
+				{
+					QueuedBytes.fetch_sub(GetQueuedSize(Line.Len()), std::memory_order_relaxed);
+					Batch.Add(MoveTemp(Line));
+				}
+			}
+			if (Batch.Num() == 0)
+			{
+				return;
+			}
+			SpaceEvent->Trigger();
+			WriteBatch(Batch);
+			NumProcessed.fetch_add(Batch.Num(), std::memory_order_release);
+			Batch.Reset();
+		}
+	}
+
+	void WriteBatch(TArrayView<const FString> Batch)
+	{
+		if (Settings.Output)
+		{
+			Settings.Output(Batch);
+			return;
+		}
+		if (!File.IsValid())
+		{
+			return;
+		}
+		TStringBuilder<4096> Text;
+		for (const FString& Line : Batch)
+		{
+			Text << Line << LINE_TERMINATOR;
+		}
+		const FTCHARToUTF8 Utf8(Text.GetData(), Text.Len());
+		File->Write(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+		File->Flush();
+	}
+
+	FReprLogSinkSettings Settings;
+	TQueue<FString, EQueueMode::Mpsc> Lines;
+	/** Serializes the consumers of Lines: the writer thread and producers dropping the oldest lines. */
+	FCriticalSection ConsumerLock;
+	std::atomic<int64> QueuedBytes{0};
+	std::atomic<int64> NumEnqueued{0};
+	/** Lines written or dropped after being queued */
+	std::atomic<int64> NumProcessed{0};
+	std::atomic<int64> NumDropped{0};
+	std::atomic<bool> bStopping{false};
+	/** Lines logged from this thread, i.e. from Output, are never blocked on */
+	std::atomic<uint32> WriterThreadId{0};
+	FEvent* WorkEvent = nullptr;
+	FEvent* SpaceEvent = nullptr;
+	TUniquePtr<IFileHandle> File;
+	FRunnableThread* Thread = nullptr;
+};
+
+FReprLogSink& FReprLogSink::Get()
+{
+	static FReprLogSink Sink;
+	return Sink;
+}
+
+void FReprLogSink::Start(FReprLogSinkSettings InSettings)
+{
+	FWriteScopeLock Lock(WriterLock);
+	// Destroying the previous writer writes its queued lines before the new one opens the output.
+	Writer.Reset();
+	Writer = MakeUnique<FWriter>(MoveTemp(InSettings));
+}
+
+void FReprLogSink::Stop()
+{
+	FWriteScopeLock Lock(WriterLock);
+	Writer.Reset();
+}
+
+bool FReprLogSink::IsRunning() const
+{
+	FReadScopeLock Lock(WriterLock);
+	return Writer.IsValid();
+}
+
+void FReprLogSink::Flush()
+{
+	FReadScopeLock Lock(WriterLock);
+	if (Writer.IsValid())
+	{
+		Writer->Flush();
+	}
+}
+
+void FReprLogSink::Enqueue(FStringView Line)
+{
+	FReadScopeLock Lock(WriterLock);
+	if (Writer.IsValid())
+	{
+		Writer->Enqueue(Line);
+	}
+}
+
+int64 FReprLogSink::GetNumDroppedLines() const
+{
+	FReadScopeLock Lock(WriterLock);
+	return Writer.IsValid() ? Writer->GetNumDropped() : 0;
+}
+
+FReprLogSink::~FReprLogSink()
+{
+	// Runs during static destruction, after the engine tore down its threads and pooled events, so the writer must
+	// already have been stopped by module shutdown. One that is somehow still running is leaked instead of joined.
+	if (Writer.IsValid())
+	{
+		FWriter* Leaked = Writer.Release();
+		(void)Leaked;
+	}
+}
+
+FStringBuilderBase& FReprLogSink::GetThreadBuilder()
+{
+	thread_local TStringBuilder<1024> Builder;
+	return Builder;
+}
@@ -0,0 +1,87 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "URepr.h"
+
+/** What FReprLogSink does with a line once the queued lines exceed MaxQueuedBytes. */
+enum class EReprLogOverflowPolicy : uint8
+{
+	/** Discard the line being logged */
+	DropNewest,
+	/** Discard the oldest queued lines until the new one fits */
+	DropOldest,
+	/** Wait on the logging thread until the writer has made room */
+	Block
+};
+
+struct FReprLogSinkSettings
+{
+	/** File the lines are appended to. Ignored when Output is bound. */
+	FString FilePath;
+	/**
+	 * Receives every batch on the writer thread instead of the file, e.g. to forward it to a socket. It must not start
+	 * or stop the sink. Lines it logs to the sink are queued, except under the Block policy with a full queue, where
+	 * they are dropped instead of waiting for the writer thread itself.
+	 */
+	TFunction<void(TArrayView<const FString>)> Output;
+	EReprLogOverflowPolicy OverflowPolicy = EReprLogOverflowPolicy::DropOldest;
+	/** Upper bound for the memory held by queued lines */
+	int64 MaxQueuedBytes = 16 * 1024 * 1024;
+	int32 MaxBatchSize = 1024;
+	/** Longest time a line waits in the queue before being written */
+	float FlushIntervalSeconds = 0.1f;
+};
+
+/**
+ * Asynchronous destination for Repr output. Lines are formatted into a per-thread buffer on the logging thread,
+ * handed to a background writer through a lock-free multi-producer queue and written in batches, so large dumps
+ * do not block on the output device redirector. Memory is bounded by MaxQueuedBytes and the overflow policy.
+ */
+class DEBUGUTILS_API FReprLogSink
+{
+public:
+	static FReprLogSink& Get();
+
+	/** Starts the writer thread. Restarting with new settings flushes and stops the previous writer first. */
+	void Start(FReprLogSinkSettings InSettings);
+	/** Writes every queued line and stops the writer thread. FDebugUtilsModule calls it on shutdown. */
+	void Stop();
+	bool IsRunning() const;
+	/** Blocks until every line queued before the call has been written. */
+	void Flush();
+
+	template <typename T>
+	void Log(const TCHAR* Name, const T& Value, const FReprOptions& Options = FReprOptions())
+	{
+		if (!IsRunning())
+		{
+			return;
+		}
+		FStringBuilderBase& Builder = GetThreadBuilder();
+		Builder << Name << TEXT(" = ");
+		ReprTo(Builder, Value, Options);
+		Enqueue(Builder.ToView());
+		Builder.Reset();
+	}
+
+	/** Queues one preformatted line. */
+	void Enqueue(FStringView Line);
+	/** @return The number of lines discarded by the overflow policy since Start */
+	int64 GetNumDroppedLines() const;
+
+	~FReprLogSink();
+
+private:
+	class FWriter;
+
+	FReprLogSink() = default;
+
+	/** Reused between lines so formatting a large value grows one buffer per thread instead of allocating each time. */
+	static FStringBuilderBase& GetThreadBuilder();
+
+	TUniquePtr<FWriter> Writer;
+	mutable FRWLock WriterLock;
+};
+
+/** Formats "x = Repr(x)" into FReprLogSink instead of UE_LOG. Does nothing while the sink is stopped. */
+#define UE_REPR_SINK(x) FReprLogSink::Get().Log(TEXT(#x), x)
+#define UE_REPR_SINK_BOUNDED(x, Options) FReprLogSink::Get().Log(TEXT(#x), x, Options)
@@ -0,0 +1,81 @@
+﻿#include "FSymbolCache.h"
+#include "DebugUtilsStats.h"
+#include "HAL/PlatformStackWalk.h"
+
+FString FCachedSymbolInfo::GetSanitizedFunctionName() const
+{
+	// Trim the trailing parenthesis pair
+	return FunctionName.LeftChop(2);
+}
+
+FString FCachedSymbolInfo::ToString() const
+{
+	return FString::Printf(TEXT("%s@%s:%d"), *Filename, *GetSanitizedFunctionName(), LineNumber);
+}
+
+FSymbolCache& FSymbolCache::Get()
+{
+	static FSymbolCache Cache;
+	return Cache;
+}
+
+uint64 FSymbolCache::CaptureProgramCounter(int32 IgnoreCount)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_CaptureStack);
+	// The same walk GetStack performs before symbolizing, so skipping IgnoreCount frames lands on the same address.
+	constexpr int32 MaxIgnoreCount = 16;
+	uint64 BackTrace[MaxIgnoreCount + 1] = {};
+	IgnoreCount = FMath::Clamp(IgnoreCount, 0, MaxIgnoreCount);
+	const uint32 Depth = FPlatformStackWalk::CaptureStackBackTrace(BackTrace, IgnoreCount + 1);
+	return Depth > static_cast<uint32>(IgnoreCount) ? BackTrace[IgnoreCount] : 0;
+}
+
+int32 FSymbolCache::CaptureBackTrace(uint64* BackTrace, int32 MaxDepth)
+{
+	return static_cast<int32>(FPlatformStackWalk::CaptureStackBackTrace(BackTrace, MaxDepth));
+}
+
+bool FSymbolCache::Resolve(uint64 ProgramCounter, FCachedSymbolInfo& Result)
+{
+	if (ProgramCounter == 0)
+	{
+		return false;
+	}
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const FCachedSymbolInfo* Cached = Symbols.Find(ProgramCounter))
+		{
+			DEBUGUTILS_COUNTER_ADD(STAT_DebugUtils_SymbolCacheHits, 1);
+			Result = *Cached;
+			return !Result.FunctionName.IsEmpty();
+		}
+	}
+
+	// Symbolize outside the lock; two threads missing on the same address just produce the same entry twice.
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_Symbolize);
+	DEBUGUTILS_COUNTER_ADD(STAT_DebugUtils_SymbolCacheMisses, 1);
+	FPlatformStackWalk::InitStackWalking();
+	FProgramCounterSymbolInfo SymbolInfo;
+	FPlatformStackWalk::ProgramCounterToSymbolInfo(ProgramCounter, SymbolInfo);
+	FCachedSymbolInfo Resolved;
+	Resolved.FunctionName = ANSI_TO_TCHAR(SymbolInfo.FunctionName);
+	Resolved.Filename = ANSI_TO_TCHAR(SymbolInfo.Filename);
+	Resolved.LineNumber = SymbolInfo.LineNumber;
+	{
+		FWriteScopeLock WriteLock(Lock);
+		Result = Symbols.FindOrAdd(ProgramCounter, MoveTemp(Resolved));
+	}
+	return !Result.FunctionName.IsEmpty();
+}
+
+void FSymbolCache::Reset()
+{
+	FWriteScopeLock WriteLock(Lock);
+	Symbols.Reset();
+}
+
+int32 FSymbolCache::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Symbols.Num();
+}
@@ -0,0 +1,54 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+
+/** The parts of FProgramCounterSymbolInfo that UCallStack reports, converted once when the address is first seen. */
+struct FCachedSymbolInfo
+{
+	FString FunctionName;
+	FString Filename;
+	int32 LineNumber = 0;
+
+	/** @return The function name without the trailing parenthesis pair, as returned by UCallStack::GetCallerName */
+	FString GetSanitizedFunctionName() const;
+	/** @return "File@Function:Line", as returned by UCallStack::GetCallerInfo */
+	FString ToString() const;
+};
+
+/**
+ * Process-wide program counter to symbol cache. Capturing a return address is cheap, symbolizing it is not,
+ * so repeated call sites cost one hash lookup under a shared lock instead of a symbol query.
+ * Thread-safe. Entries are never evicted because the number of distinct call sites in a program is bounded.
+ */
+class DEBUGUTILS_API FSymbolCache
+{
+public:
+	static FSymbolCache& Get();
+
+	/**
+	 * Captures a single return address without symbolizing it.
+	 * Skips frames exactly like FPlatformStackWalk::GetStack(IgnoreCount, 1) does when called from the same place.
+	 * @return The program counter, or 0 if the stack could not be walked
+	 */
+	static FORCENOINLINE uint64 CaptureProgramCounter(int32 IgnoreCount);
+	/**
+	 * Captures up to MaxDepth return addresses from the same call depth as CaptureProgramCounter, so skipping
+	 * IgnoreCount of them lands on the frame CaptureProgramCounter(IgnoreCount) returns.
+	 * @return The number of addresses written to BackTrace
+	 */
+	static FORCENOINLINE int32 CaptureBackTrace(uint64* BackTrace, int32 MaxDepth);
+
+	/**
+	 * Looks up the symbol for a program counter, symbolizing and caching it on the first request.
+	 * @return Whether the address could be symbolized
+	 */
+	bool Resolve(uint64 ProgramCounter, FCachedSymbolInfo& Result);
+	/** Drops every cached symbol, e.g. after modules were reloaded. */
+	void Reset();
+	int32 Num() const;
+
+private:
+	mutable FRWLock Lock;
+	/** Addresses that failed to symbolize are cached too, with an empty function name. */
+	TMap<uint64, FCachedSymbolInfo> Symbols;
+};
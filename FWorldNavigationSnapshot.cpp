@@ -0,0 +1,277 @@
+﻿#include "FWorldNavigationSnapshot.h"
+#include "UWorldNavigator.h"
+#include "Components/SceneComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/ScopeRWLock.h"
+#include "Misc/StringBuilder.h"
+
+namespace
+{
+	using FSnapshotPtr = TSharedPtr<const FWorldNavigationSnapshot, ESPMode::ThreadSafe>;
+
+	struct FSnapshotRegistry
+	{
+		FRWLock Lock;
+		TMap<FName, FSnapshotPtr> Snapshots;
+		uint32 NextVersion = 1;
+	};
+
+	FSnapshotRegistry& GetSnapshotRegistry()
+	{
+		static FSnapshotRegistry Registry;
+		return Registry;
+	}
+
+	FDelegateHandle WorldCleanupHandle;
+
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		// A snapshot must not outlive its world under the same name, or a new world with that name would resolve against it.
+		FWorldNavigationSnapshot::Unpublish(World);
+	}
+
+	/** Hands out same-name indices in enumeration order within one owner. */
+	struct FSameNameCounter
+	{
+		TMap<FName, int32> NextIndices;
+
+		int32 Next(FName Name)
+		{
+			return NextIndices.FindOrAdd(Name)++;
+		}
+	};
+}
+
+TSharedRef<const FWorldNavigationSnapshot, ESPMode::ThreadSafe> FWorldNavigationSnapshot::Publish(UWorld* World)
+{
+	check(IsInGameThread());
+	check(World != nullptr);
+	TSharedRef<FWorldNavigationSnapshot, ESPMode::ThreadSafe> Snapshot = MakeShareable(
+		new FWorldNavigationSnapshot(World));
+	FSnapshotRegistry& Registry = GetSnapshotRegistry();
+	FWriteScopeLock WriteLock(Registry.Lock);
+	Snapshot->Version = Registry.NextVersion++;
+	Registry.Snapshots.Add(Snapshot->WorldName, Snapshot);
+	return Snapshot;
+}
+
+void FWorldNavigationSnapshot::Unpublish(const UWorld* World)
+{
+	check(IsInGameThread());
+	FSnapshotRegistry& Registry = GetSnapshotRegistry();
+	FWriteScopeLock WriteLock(Registry.Lock);
+	Registry.Snapshots.Remove(World->GetFName());
+}
+
+void FWorldNavigationSnapshot::StartTrackingWorlds()
+{
+	if (!WorldCleanupHandle.IsValid())
+	{
+		WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&OnWorldCleanup);
+	}
+}
+
+void FWorldNavigationSnapshot::StopTrackingWorlds()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	WorldCleanupHandle.Reset();
+	FSnapshotRegistry& Registry = GetSnapshotRegistry();
+	FWriteScopeLock WriteLock(Registry.Lock);
+	Registry.Snapshots.Reset();
+}
+
+TSharedPtr<const FWorldNavigationSnapshot, ESPMode::ThreadSafe> FWorldNavigationSnapshot::Find(FName WorldName)
+{
+	FSnapshotRegistry& Registry = GetSnapshotRegistry();
+	FReadScopeLock ReadLock(Registry.Lock);
+	const FSnapshotPtr* Snapshot = Registry.Snapshots.Find(WorldName);
+	return Snapshot != nullptr ? *Snapshot : nullptr;
+}
+
+FWorldNavigationSnapshot::FWorldNavigationSnapshot(UWorld* World)
+	: WorldName(World->GetFName())
+{
+	FSameNameCounter LevelCounter;
+	TArray<TPair<USceneComponent*, int32>> SceneComponents;
+	for (auto Level : UWorldNavigator::GetAllLevelsInWorld(World))
+	{
+		if (Level == nullptr)
+		{
+			continue;
+		}
+		const int32 LevelNode = AddNode(Level, Level->GetFName(), LevelCounter.Next(Level->GetFName()), INDEX_NONE,
+		                                ENodeKind::Level);
+		FSameNameCounter ActorCounter;
+		for (AActor* Actor : Level->Actors)
+		{
+			if (Actor == nullptr)
+			{
+				continue;
+			}
+			const int32 ActorNode = AddNode(Actor, Actor->GetFName(), ActorCounter.Next(Actor->GetFName()),
+			                                LevelNode, ENodeKind::Actor);
+			FSameNameCounter ComponentCounter;
+			for (auto Component : UWorldNavigator::GetAllComponentsInActor(Actor))
+			{
+				USceneComponent* SceneComponent = Cast<USceneComponent>(Component);
+				const int32 ComponentNode = AddNode(Component, Component->GetFName(),
+				                                    ComponentCounter.Next(Component->GetFName()), ActorNode,
+				                                    SceneComponent != nullptr
+					                                    ? ENodeKind::SceneComponent
+					                                    : ENodeKind::ActorComponent);
+				if (SceneComponent != nullptr)
+				{
+					SceneComponents.Emplace(SceneComponent, ComponentNode);
+				}
+			}
+		}
+	}
+	// Attach parents can belong to actors that were added later, so link them once every node exists.
+	for (const auto& Pair : SceneComponents)
+	{
+		if (const int32* ParentNode = NodesByObject.Find(FObjectKey(Pair.Key->GetAttachParent())))
+		{
+			FNode& Node = Nodes[Pair.Value];
+			Node.AttachParent = *ParentNode;
+			AttachChildren.Add({Node.AttachParent, Node.Name, Node.SameNameIndex}, Pair.Value);
+		}
+	}
+}
+
+uint32 FWorldNavigationSnapshot::GetVersion() const
+{
+	return Version;
+}
+
+FName FWorldNavigationSnapshot::GetWorldName() const
+{
+	return WorldName;
+}
+
+FString FWorldNavigationSnapshot::GetWorldPath(FObjectKey Object) const
+{
+	const int32* NodeIndex = NodesByObject.Find(Object);
+	if (NodeIndex == nullptr)
+	{
+		return TEXT("[invalid actor]");
+	}
+	const FNode& Node = Nodes[*NodeIndex];
+	if (Node.Kind == ENodeKind::Level)
+	{
+		return TEXT("[invalid actor]");
+	}
+	const FNode& ActorNode = Node.Kind == ENodeKind::Actor ? Node : Nodes[Node.Owner];
+	const FNode& LevelNode = Nodes[ActorNode.Owner];
+	TStringBuilder<256> Builder;
+	Builder << WorldName << TEXT('@') << LevelNode.Name << TEXT('[') << LevelNode.SameNameIndex << TEXT("]:/")
+		<< ActorNode.Name << TEXT('[') << ActorNode.SameNameIndex << TEXT(']');
+	if (Node.Kind == ENodeKind::ActorComponent)
+	{
+		Builder << TEXT("->") << Node.Name << TEXT('[') << Node.SameNameIndex << TEXT(']');
+	}
+	else if (Node.Kind == ENodeKind::SceneComponent)
+	{
+		Builder << TEXT("->");
+		AppendComponentHierarchy(Builder, *NodeIndex);
+	}
+	return FString(Builder.Len(), Builder.GetData());
+}
+
+bool FWorldNavigationSnapshot::Contains(FObjectKey Object) const
+{
+	return NodesByObject.Contains(Object);
+}
+
+FObjectKey FWorldNavigationSnapshot::FindActorByPath(const FCompiledPathStructure& Path) const
+{
+	const int32 ActorNode = FindActorNode(Path);
+	return ActorNode != INDEX_NONE ? Nodes[ActorNode].Object : FObjectKey();
+}
+
+FObjectKey FWorldNavigationSnapshot::FindActorComponentByPath(const FCompiledPathStructure& Path) const
+{
+	const int32 ActorNode = FindActorNode(Path);
+	if (ActorNode == INDEX_NONE or Path.ComponentNames.Num() != 1 or Path.ComponentIndices.Num() != 1)
+	{
+		return FObjectKey();
+	}
+	const int32 ComponentNode = FindChild(ActorNode, Path.ComponentNames[0], Path.ComponentIndices[0]);
+	return ComponentNode != INDEX_NONE ? Nodes[ComponentNode].Object : FObjectKey();
+}
+
+FObjectKey FWorldNavigationSnapshot::FindSceneComponentByPath(const FCompiledPathStructure& Path) const
+{
+	const int32 ActorNode = FindActorNode(Path);
+	if (ActorNode == INDEX_NONE or Path.ComponentNames.Num() == 0
+		or Path.ComponentNames.Num() != Path.ComponentIndices.Num())
+	{
+		return FObjectKey();
+	}
+	// Descend the attach hierarchy from the first segment, like UWorldNavigator::FindSceneComponentByPath.
+	int32 ComponentNode = FindChild(ActorNode, Path.ComponentNames[0], Path.ComponentIndices[0]);
+	for (int32 i = 1; i < Path.ComponentNames.Num() and ComponentNode != INDEX_NONE; ++i)
+	{
+		const int32* ChildNode = AttachChildren.Find({ComponentNode, Path.ComponentNames[i], Path.ComponentIndices[i]});
+		ComponentNode = ChildNode != nullptr ? *ChildNode : INDEX_NONE;
+	}
+	if (ComponentNode == INDEX_NONE or Nodes[ComponentNode].Kind != ENodeKind::SceneComponent)
+	{
+		return FObjectKey();
+	}
+	return Nodes[ComponentNode].Object;
+}
+
+int32 FWorldNavigationSnapshot::AddNode(UObject* Object, FName Name, int32 SameNameIndex, int32 Owner,
+                                        ENodeKind Kind)
+{
+	const int32 NodeIndex = Nodes.AddDefaulted();
+	FNode& Node = Nodes[NodeIndex];
+	Node.Object = FObjectKey(Object);
+	Node.Name = Name;
+	Node.SameNameIndex = SameNameIndex;
+	Node.Owner = Owner;
+	Node.Kind = Kind;
+	NodesByObject.Add(Node.Object, NodeIndex);
+	Children.Add({Owner, Name, SameNameIndex}, NodeIndex);
+	return NodeIndex;
+}
+
+int32 FWorldNavigationSnapshot::FindChild(int32 Owner, FName Name, int32 SameNameIndex) const
+{
+	const int32* NodeIndex = Children.Find({Owner, Name, SameNameIndex});
+	return NodeIndex != nullptr ? *NodeIndex : INDEX_NONE;
+}
+
+int32 FWorldNavigationSnapshot::FindActorNode(const FCompiledPathStructure& Path) const
+{
+	if (Path.WorldName != WorldName)
+	{
+		return INDEX_NONE;
+	}
+	const int32 LevelNode = FindChild(INDEX_NONE, Path.LevelName, Path.LevelIndex);
+	if (LevelNode == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+	return FindChild(LevelNode, Path.ActorName, Path.ActorIndex);
+}
+
+void FWorldNavigationSnapshot::AppendComponentHierarchy(FStringBuilderBase& Builder, int32 NodeIndex) const
+{
+	TArray<int32, TInlineAllocator<16>> Hierarchy;
+	for (int32 Current = NodeIndex; Current != INDEX_NONE; Current = Nodes[Current].AttachParent)
+	{
+		Hierarchy.Add(Current);
+	}
+	for (int32 i = Hierarchy.Num() - 1; i >= 0; --i)
+	{
+		const FNode& Node = Nodes[Hierarchy[i]];
+		Builder << Node.Name << TEXT('[') << Node.SameNameIndex << TEXT(']');
+		if (i > 0)
+		{
+			Builder << TEXT('/');
+		}
+	}
+}
@@ -0,0 +1,100 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "FPathStructure.h"
+
+class UWorld;
+
+/**
+ * Immutable copy of a world's navigation data: names, same-name indices and parent links of its levels, actors
+ * and components. The game thread builds and publishes it; any thread can then generate and resolve world paths
+ * against it concurrently without touching UObjects.
+ * Objects are identified by FObjectKey. Resolve a key back to an object on the game thread with ResolveObjectPtr.
+ */
+class DEBUGUTILS_API FWorldNavigationSnapshot
+{
+public:
+	/**
+	 * Builds a snapshot of the world and makes it the one returned by Find for the world's name.
+	 * Game thread only. Earlier snapshots stay valid for the threads still holding them.
+	 */
+	static TSharedRef<const FWorldNavigationSnapshot, ESPMode::ThreadSafe> Publish(UWorld* World);
+	/** Drops the published snapshot of the world. Game thread only. */
+	static void Unpublish(const UWorld* World);
+	/** @return The latest snapshot published for the world with that name, or nullptr. Thread-safe. */
+	static TSharedPtr<const FWorldNavigationSnapshot, ESPMode::ThreadSafe> Find(FName WorldName);
+	/**
+	 * Starts and stops unpublishing snapshots when their world is cleaned up. Called from the module's startup and
+	 * shutdown; stopping also drops every published snapshot.
+	 */
+	static void StartTrackingWorlds();
+	static void StopTrackingWorlds();
+
+	/** @return A number that grows with every published snapshot, for telling stale snapshots apart */
+	uint32 GetVersion() const;
+	FName GetWorldName() const;
+
+	/** @return The same path UWorldNavigator::GetWorldPath returned when the snapshot was taken, or the matching error string */
+	FString GetWorldPath(FObjectKey Object) const;
+	/** @return Whether the object was part of the world when the snapshot was taken */
+	bool Contains(FObjectKey Object) const;
+
+	FObjectKey FindActorByPath(const FCompiledPathStructure& Path) const;
+	FObjectKey FindActorComponentByPath(const FCompiledPathStructure& Path) const;
+	FObjectKey FindSceneComponentByPath(const FCompiledPathStructure& Path) const;
+
+private:
+	enum class ENodeKind : uint8
+	{
+		Level,
+		Actor,
+		ActorComponent,
+		SceneComponent
+	};
+
+	struct FNode
+	{
+		FObjectKey Object;
+		FName Name;
+		int32 SameNameIndex = 0;
+		/** The world level list position for levels, the level for actors and the owning actor for components */
+		int32 Owner = INDEX_NONE;
+		/** The attach parent for scene components, which may belong to another actor */
+		int32 AttachParent = INDEX_NONE;
+		ENodeKind Kind = ENodeKind::Level;
+	};
+
+	/** (Owner, Name, SameNameIndex) of a child node, INDEX_NONE as owner for levels */
+	struct FChildKey
+	{
+		int32 Owner;
+		FName Name;
+		int32 SameNameIndex;
+
+		bool operator==(const FChildKey& Other) const
+		{
+			return Owner == Other.Owner and Name == Other.Name and SameNameIndex == Other.SameNameIndex;
+		}
+
+		friend uint32 GetTypeHash(const FChildKey& Key)
+		{
+			return HashCombine(HashCombine(::GetTypeHash(Key.Owner), GetTypeHash(Key.Name)),
+			                   ::GetTypeHash(Key.SameNameIndex));
+		}
+	};
+
+	explicit FWorldNavigationSnapshot(UWorld* World);
+
+	int32 AddNode(UObject* Object, FName Name, int32 SameNameIndex, int32 Owner, ENodeKind Kind);
+	int32 FindChild(int32 Owner, FName Name, int32 SameNameIndex) const;
+	int32 FindActorNode(const FCompiledPathStructure& Path) const;
+	void AppendComponentHierarchy(FStringBuilderBase& Builder, int32 NodeIndex) const;
+
+	FName WorldName;
+	uint32 Version = 0;
+	TArray<FNode> Nodes;
+	TMap<FObjectKey, int32> NodesByObject;
+	TMap<FChildKey, int32> Children;
+	/** Scene components keyed by (AttachParent, Name, SameNameIndex) */
+	TMap<FChildKey, int32> AttachChildren;
+};
@@ -0,0 +1,554 @@
+﻿#include "FWorldPathIndex.h"
+#include "UWorldNavigator.h"
+#include "DebugUtilsStats.h"
+#include "FPathStructure.h"
+#include "FPersistedWorldPathIndex.h"
+#include "Algo/BinarySearch.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
+
+namespace
+{
+	TMap<const UWorld*, TUniquePtr<FWorldPathIndex>>& GetRegisteredIndices()
+	{
+		static TMap<const UWorld*, TUniquePtr<FWorldPathIndex>> Indices;
+		return Indices;
+	}
+}
+
+FWorldPathIndex::FWorldPathIndex(UWorld* InWorld, bool bTrackChanges)
+	: World(InWorld)
+{
+	check(InWorld != nullptr);
+	if (!bTrackChanges)
+	{
+		return;
+	}
+	ActorSpawnedHandle = InWorld->AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateRaw(this, &FWorldPathIndex::OnActorSpawned));
+	ActorDestroyedHandle = InWorld->AddOnActorDestroyedHandler(
+		FOnActorDestroyed::FDelegate::CreateRaw(this, &FWorldPathIndex::OnActorDestroyed));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FWorldPathIndex::OnLevelChanged);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FWorldPathIndex::OnLevelChanged);
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddRaw(this, &FWorldPathIndex::OnWorldCleanup);
+}
+
+FWorldPathIndex::~FWorldPathIndex()
+{
+	UWorld* IndexedWorld = World.Get();
+	if (IndexedWorld != nullptr and ActorSpawnedHandle.IsValid())
+	{
+		IndexedWorld->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		IndexedWorld->RemoveOnActorDestroyededHandler(ActorDestroyedHandle);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+}
+
+FWorldPathIndex& FWorldPathIndex::Register(UWorld* World)
+{
+	check(IsInGameThread());
+	TUniquePtr<FWorldPathIndex>& Index = GetRegisteredIndices().FindOrAdd(World);
+	if (!Index.IsValid())
+	{
+		Index = MakeUnique<FWorldPathIndex>(World);
+	}
+	return *Index;
+}
+
+void FWorldPathIndex::Unregister(const UWorld* World)
+{
+	check(IsInGameThread());
+	GetRegisteredIndices().Remove(World);
+}
+
+FWorldPathIndex* FWorldPathIndex::Find(const UWorld* World)
+{
+	const TUniquePtr<FWorldPathIndex>* Index = GetRegisteredIndices().Find(World);
+	return Index != nullptr ? Index->Get() : nullptr;
+}
+
+FWorldPathIndex* FWorldPathIndex::FindByWorldName(FName WorldName)
+{
+	for (const auto& Pair : GetRegisteredIndices())
+	{
+		const UWorld* IndexedWorld = Pair.Value->GetWorld();
+		if (IndexedWorld != nullptr and IndexedWorld->GetFName() == WorldName)
+		{
+			return Pair.Value.Get();
+		}
+	}
+	return nullptr;
+}
+
+UWorld* FWorldPathIndex::GetWorld() const
+{
+	return World.Get();
+}
+
+ULevel* FWorldPathIndex::FindLevel(FName LevelName, int32 LevelIndex)
+{
+	if (!bLevelsBuilt)
+	{
+		BuildLevels();
+	}
+	return Levels.Find(LevelName, LevelIndex);
+}
+
+AActor* FWorldPathIndex::FindActor(ULevel* Level, FName ActorName, int32 ActorIndex)
+{
+	if (Level == nullptr)
+	{
+		return nullptr;
+	}
+	if (Persisted.IsValid() and !LevelTables.Contains(Level))
+	{
+		if (AActor* Actor = Persisted->FindActor(Level, ActorName, ActorIndex))
+		{
+			return Actor;
+		}
+	}
+	return FindOrBuildLevelTable(Level).Find(ActorName, ActorIndex);
+}
+
+UActorComponent* FWorldPathIndex::FindComponent(AActor* Actor, FName ComponentName, int32 ComponentIndex)
+{
+	if (Actor == nullptr)
+	{
+		return nullptr;
+	}
+	FActorTable& Table = FindOrBuildActorTable(Actor);
+	UActorComponent* Component = Table.Components.Find(ComponentName, ComponentIndex);
+	if ((Component == nullptr or Component->GetOwner() != Actor) and RebuildActorTableAfterMiss(Actor, Table))
+	{
+		Component = Table.Components.Find(ComponentName, ComponentIndex);
+	}
+	return Component;
+}
+
+int32 FWorldPathIndex::GetLevelIndex(ULevel* Level)
+{
+	if (!bLevelsBuilt)
+	{
+		BuildLevels();
+	}
+	return Levels.GetIndex(Level);
+}
+
+int32 FWorldPathIndex::GetActorIndex(AActor* Actor)
+{
+	ULevel* Level = Actor->GetLevel();
+	if (Level == nullptr)
+	{
+		return INDEX_NONE;
+	}
+	TNameTable<AActor>& Table = FindOrBuildLevelTable(Level);
+	const int32 Index = Table.GetIndex(Actor);
+	if (Index != INDEX_NONE)
+	{
+		return Index;
+	}
+	// Renamed or moved actors are not announced, so rebuild the level before giving up, at most once per frame.
+	if (Table.BuildFrame == GFrameCounter)
+	{
+		return INDEX_NONE;
+	}
+	BuildLevelTable(Level, Table);
+	return Table.GetIndex(Actor);
+}
+
+int32 FWorldPathIndex::GetComponentIndex(UActorComponent* Component)
+{
+	AActor* Owner = Component->GetOwner();
+	if (Owner == nullptr)
+	{
+		return INDEX_NONE;
+	}
+	FActorTable& Table = FindOrBuildActorTable(Owner);
+	const int32 Index = Table.Components.GetIndex(Component);
+	if (Index != INDEX_NONE or !RebuildActorTableAfterMiss(Owner, Table))
+	{
+		return Index;
+	}
+	return Table.Components.GetIndex(Component);
+}
+
+void FWorldPathIndex::AttachPersisted(TUniquePtr<FPersistedWorldPathIndex> InPersisted)
+{
+	Persisted = MoveTemp(InPersisted);
+	++Generation;
+}
+
+void FWorldPathIndex::Invalidate()
+{
+	Persisted.Reset();
+	Levels.Reset();
+	bLevelsBuilt = false;
+	LevelTables.Reset();
+	ActorTables.Reset();
+	++Generation;
+}
+
+uint32 FWorldPathIndex::GetGeneration() const
+{
+	return Generation;
+}
+
+template <typename T>
+void FWorldPathIndex::TNameTable<T>::Add(T* Object)
+{
+	const int32 NumBuckets = Buckets.Num();
+	auto& Bucket = Buckets.FindOrAdd(Object->GetFName());
+	if (Buckets.Num() != NumBuckets)
+	{
+		bSortedNamesValid = false;
+	}
+	Indices.Add(Object, Bucket.Num());
+	Bucket.Add(Object);
+}
+
+template <typename T>
+bool FWorldPathIndex::TNameTable<T>::Remove(T* Object)
+{
+	const int32* Index = Indices.Find(Object);
+	if (Index == nullptr)
+	{
+		return false;
+	}
+	const FName Name = Object->GetFName();
+	auto Bucket = Buckets.Find(Name);
+	if (Bucket == nullptr or !Bucket->IsValidIndex(*Index) or (*Bucket)[*Index].Get() != Object)
+	{
+		// The object was renamed since it was added; a full rebuild is the only safe option.
+		Reset();
+		return true;
+	}
+	const int32 RemovedIndex = *Index;
+	Indices.Remove(Object);
+	Bucket->RemoveAt(RemovedIndex);
+	for (int32 i = RemovedIndex; i < Bucket->Num(); ++i)
+	{
+		if (T* Shifted = (*Bucket)[i].Get())
+		{
+			Indices.Add(Shifted, i);
+		}
+	}
+	const bool bShifted = RemovedIndex < Bucket->Num();
+	if (Bucket->Num() == 0)
+	{
+		Buckets.Remove(Name);
+		bSortedNamesValid = false;
+	}
+	return bShifted;
+}
+
+template <typename T>
+void FWorldPathIndex::TNameTable<T>::Reset()
+{
+	Buckets.Reset();
+	Indices.Reset();
+	SortedNames.Reset();
+	bSortedNamesValid = false;
+}
+
+template <typename T>
+T* FWorldPathIndex::TNameTable<T>::Find(FName Name, int32 Index) const
+{
+	const auto Bucket = Buckets.Find(Name);
+	if (Bucket == nullptr or !Bucket->IsValidIndex(Index))
+	{
+		return nullptr;
+	}
+	T* Object = (*Bucket)[Index].Get();
+	if (Object == nullptr or Object->GetFName() != Name)
+	{
+		return nullptr;
+	}
+	return Object;
+}
+
+template <typename T>
+int32 FWorldPathIndex::TNameTable<T>::GetIndex(const T* Object) const
+{
+	const int32* Index = Indices.Find(Object);
+	if (Index == nullptr)
+	{
+		return INDEX_NONE;
+	}
+	// Guard against renames that happened after the object was indexed.
+	const auto Bucket = Buckets.Find(Object->GetFName());
+	if (Bucket == nullptr or !Bucket->IsValidIndex(*Index) or (*Bucket)[*Index].Get() != Object)
+	{
+		return INDEX_NONE;
+	}
+	return *Index;
+}
+
+template <typename T>
+void FWorldPathIndex::TNameTable<T>::FindMatches(const FPathPatternSegment& Segment, TArray<T*>& Result)
+{
+	if (Segment.Kind == FPathPatternSegment::EKind::Exact)
+	{
+		AppendBucket(Segment.Name, Segment, Result);
+		return;
+	}
+	if (!bSortedNamesValid)
+	{
+		SortedNames.Reset(Buckets.Num());
+		for (const auto& Pair : Buckets)
+		{
+			SortedNames.Emplace(Pair.Key.ToString(), Pair.Key);
+		}
+		// FString ordering ignores case like FName does, so every name sharing a prefix ends up in one run.
+		SortedNames.Sort([](const TPair<FString, FName>& A, const TPair<FString, FName>& B) { return A.Key < B.Key; });
+		bSortedNamesValid = true;
+	}
+	if (Segment.Kind == FPathPatternSegment::EKind::Prefix)
+	{
+		const int32 First = Algo::LowerBoundBy(SortedNames, Segment.Pattern,
+		                                       [](const TPair<FString, FName>& Entry) -> const FString& { return Entry.Key; });
+		for (int32 i = First; i < SortedNames.Num() and SortedNames[i].Key.StartsWith(Segment.Pattern); ++i)
+		{
+			AppendBucket(SortedNames[i].Value, Segment, Result);
+		}
+		return;
+	}
+	for (const auto& Entry : SortedNames)
+	{
+		if (Segment.MatchesName(Entry.Key))
+		{
+			AppendBucket(Entry.Value, Segment, Result);
+		}
+	}
+}
+
+template <typename T>
+void FWorldPathIndex::TNameTable<T>::AppendBucket(FName Name, const FPathPatternSegment& Segment,
+                                                  TArray<T*>& Result) const
+{
+	const auto Bucket = Buckets.Find(Name);
+	if (Bucket == nullptr)
+	{
+		return;
+	}
+	const int32 First = Segment.Index == INDEX_NONE ? 0 : Segment.Index;
+	const int32 End = Segment.Index == INDEX_NONE ? Bucket->Num() : FMath::Min(Segment.Index + 1, Bucket->Num());
+	for (int32 i = First; i < End; ++i)
+	{
+		T* Object = (*Bucket)[i].Get();
+		if (Object != nullptr and Object->GetFName() == Name)
+		{
+			Result.Add(Object);
+		}
+	}
+}
+
+void FWorldPathIndex::FindLevels(const FPathPatternSegment& Segment, TArray<ULevel*>& Result)
+{
+	if (!bLevelsBuilt)
+	{
+		BuildLevels();
+	}
+	Levels.FindMatches(Segment, Result);
+}
+
+void FWorldPathIndex::FindActors(ULevel* Level, const FPathPatternSegment& Segment, TArray<AActor*>& Result)
+{
+	if (Level != nullptr)
+	{
+		FindOrBuildLevelTable(Level).FindMatches(Segment, Result);
+	}
+}
+
+void FWorldPathIndex::FindComponents(AActor* Actor, TArrayView<const FPathPatternSegment> Segments,
+                                     TArray<UActorComponent*>& Result)
+{
+	if (Actor == nullptr or Segments.Num() == 0)
+	{
+		return;
+	}
+	if (Segments[0].Kind == FPathPatternSegment::EKind::AnyDepth)
+	{
+		Result.Append(UWorldNavigator::GetAllComponentsInActor(Actor));
+		return;
+	}
+	TArray<UActorComponent*> Matches;
+	FindOrBuildActorTable(Actor).Components.FindMatches(Segments[0], Matches);
+	for (int32 i = 1; i < Segments.Num() and Matches.Num() > 0; ++i)
+	{
+		TArray<UActorComponent*> Children;
+		for (UActorComponent* Component : Matches)
+		{
+			if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+			{
+				FindAttachChildren(SceneComponent, Segments[i], Children);
+			}
+		}
+		Matches = MoveTemp(Children);
+	}
+	Result.Append(Matches);
+}
+
+void FWorldPathIndex::FindAttachChildren(USceneComponent* Parent, const FPathPatternSegment& Segment,
+                                         TArray<UActorComponent*>& Result)
+{
+	if (Segment.Kind == FPathPatternSegment::EKind::AnyDepth)
+	{
+		TArray<USceneComponent*> Descendants;
+		Parent->GetChildrenComponents(true, Descendants);
+		Result.Append(Descendants);
+		return;
+	}
+	for (USceneComponent* Child : Parent->GetAttachChildren())
+	{
+		if (Child != nullptr and Segment.MatchesName(Child->GetFName())
+			and (Segment.Index == INDEX_NONE or GetComponentIndex(Child) == Segment.Index))
+		{
+			Result.Add(Child);
+		}
+	}
+}
+
+void FWorldPathIndex::BuildLevels()
+{
+	DEBUGUTILS_COUNTER_ADD(STAT_DebugUtils_PathIndexTableBuilds, 1);
+	Levels.Reset();
+	if (UWorld* IndexedWorld = World.Get())
+	{
+		for (auto Level : UWorldNavigator::GetAllLevelsInWorld(IndexedWorld))
+		{
+			if (Level != nullptr)
+			{
+				Levels.Add(Level);
+			}
+		}
+	}
+	bLevelsBuilt = true;
+}
+
+FWorldPathIndex::TNameTable<AActor>& FWorldPathIndex::FindOrBuildLevelTable(ULevel* Level)
+{
+	if (TNameTable<AActor>* Table = LevelTables.Find(Level))
+	{
+		return *Table;
+	}
+	TNameTable<AActor>& Table = LevelTables.Add(Level);
+	BuildLevelTable(Level, Table);
+	return Table;
+}
+
+void FWorldPathIndex::BuildLevelTable(ULevel* Level, TNameTable<AActor>& Table)
+{
+	DEBUGUTILS_COUNTER_ADD(STAT_DebugUtils_PathIndexTableBuilds, 1);
+	Table.Reset();
+	for (AActor* Actor : Level->Actors)
+	{
+		if (Actor != nullptr)
+		{
+			Table.Add(Actor);
+		}
+	}
+	Table.BuildFrame = GFrameCounter;
+}
+
+FWorldPathIndex::FActorTable& FWorldPathIndex::FindOrBuildActorTable(AActor* Actor)
+{
+	FActorTable& Table = ActorTables.FindOrAdd(Actor);
+	// The sorted component table stays valid until the component set changes.
+	if (Table.NumComponents != Actor->GetComponents().Num())
+	{
+		BuildActorTable(Actor, Table);
+	}
+	return Table;
+}
+
+void FWorldPathIndex::BuildActorTable(AActor* Actor, FActorTable& Table)
+{
+	DEBUGUTILS_COUNTER_ADD(STAT_DebugUtils_PathIndexTableBuilds, 1);
+	Table.Components.Reset();
+	const auto Components = UWorldNavigator::GetAllComponentsInActor(Actor);
+	for (auto Component : Components)
+	{
+		Table.Components.Add(Component);
+	}
+	Table.Components.BuildFrame = GFrameCounter;
+	Table.NumComponents = Components.Num();
+}
+
+bool FWorldPathIndex::RebuildActorTableAfterMiss(AActor* Actor, FActorTable& Table)
+{
+	// A path that stays stale, e.g. one polled every frame, would otherwise rebuild the table on every lookup.
+	if (Table.Components.BuildFrame == GFrameCounter)
+	{
+		return false;
+	}
+	BuildActorTable(Actor, Table);
+	return true;
+}
+
+void FWorldPathIndex::OnActorSpawned(AActor* Actor)
+{
+	// Spawned actors are appended to ULevel::Actors, so appending keeps the same-name indices stable and every
+	// cached path still resolves to the same object.
+	if (TNameTable<AActor>* Table = LevelTables.Find(Actor->GetLevel()))
+	{
+		Table->Add(Actor);
+	}
+}
+
+void FWorldPathIndex::OnActorDestroyed(AActor* Actor)
+{
+	ULevel* Level = Actor->GetLevel();
+	// Only same-name actors after the destroyed one change index. A level without a table has not resolved any
+	// path through this index, unless the persisted file answered for it.
+	bool bShiftedIndices = false;
+	if (Persisted.IsValid() and Persisted->IsBound(Level))
+	{
+		// Removing an actor shifts the same-name indices stored in the file.
+		Persisted->Unbind(Level);
+		bShiftedIndices = true;
+	}
+	if (TNameTable<AActor>* Table = LevelTables.Find(Level))
+	{
+		bShiftedIndices |= Table->Remove(Actor);
+		if (Table->Buckets.Num() == 0)
+		{
+			LevelTables.Remove(Level);
+		}
+	}
+	ActorTables.Remove(Actor);
+	if (bShiftedIndices)
+	{
+		++Generation;
+	}
+}
+
+void FWorldPathIndex::OnLevelChanged(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld != World.Get())
+	{
+		return;
+	}
+	++Generation;
+	if (Persisted.IsValid())
+	{
+		Persisted->Unbind(Level);
+	}
+	// The level list is short, so it is cheaper to rebuild it than to patch the bucket order.
+	Levels.Reset();
+	bLevelsBuilt = false;
+	LevelTables.Remove(Level);
+}
+
+void FWorldPathIndex::OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources)
+{
+	if (InWorld == World.Get())
+	{
+		// Destroys this index, so nothing may touch members afterwards.
+		Unregister(InWorld);
+	}
+}
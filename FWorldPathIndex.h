@@ -0,0 +1,135 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class AActor;
+class FPersistedWorldPathIndex;
+class UActorComponent;
+class ULevel;
+class USceneComponent;
+class UWorld;
+struct FPathPatternSegment;
+
+/**
+ * Opt-in lookup tables that let UWorldNavigator resolve paths in a world with hash lookups.
+ * Maps (LevelName, LevelIndex) to levels, (ActorName, ActorIndex) to actors and keeps one component table per actor.
+ * Tables are built lazily and kept up to date from actor spawn/destroy and level add/remove notifications,
+ * and they also answer the reverse question (the same-name index of an object) used by GetWorldPath.
+ * Must only be used from the game thread.
+ */
+class DEBUGUTILS_API FWorldPathIndex
+{
+public:
+	/**
+	 * @param InWorld The world to index
+	 * @param bTrackChanges Whether to listen for world changes. Untracked indices are scratch caches for a single operation.
+	 */
+	explicit FWorldPathIndex(UWorld* InWorld, bool bTrackChanges = true);
+	~FWorldPathIndex();
+
+	/**
+	 * Starts indexing the given world. Lookups through UWorldNavigator use the index from now on.
+	 * @return The index for the world, created if it was not registered yet
+	 */
+	static FWorldPathIndex& Register(UWorld* World);
+	/** Stops indexing the given world and releases its tables. */
+	static void Unregister(const UWorld* World);
+	/** @return The index registered for the world, or nullptr if the world is not indexed */
+	static FWorldPathIndex* Find(const UWorld* World);
+	/** @return The index of the registered world with the given name, or nullptr if there is none */
+	static FWorldPathIndex* FindByWorldName(FName WorldName);
+
+	UWorld* GetWorld() const;
+	ULevel* FindLevel(FName LevelName, int32 LevelIndex);
+	AActor* FindActor(ULevel* Level, FName ActorName, int32 ActorIndex);
+	UActorComponent* FindComponent(AActor* Actor, FName ComponentName, int32 ComponentIndex);
+	/** @return The index of the level among the world's levels with the same name, or INDEX_NONE */
+	int32 GetLevelIndex(ULevel* Level);
+	/** @return The index of the actor among the actors with the same name in its level, or INDEX_NONE */
+	int32 GetActorIndex(AActor* Actor);
+	/** @return The index of the component among its owner's components with the same name, or INDEX_NONE */
+	int32 GetComponentIndex(UActorComponent* Component);
+	/**
+	 * Pattern lookups. Exact names are one hash lookup and prefixes a binary search over the sorted names of the
+	 * table, so the cost follows the number of matches rather than the number of objects; other wildcards test
+	 * each distinct name once. Matches are appended to Result.
+	 */
+	void FindLevels(const FPathPatternSegment& Segment, TArray<ULevel*>& Result);
+	void FindActors(ULevel* Level, const FPathPatternSegment& Segment, TArray<AActor*>& Result);
+	/** Matches the component segments of a pattern: the first among the actor's components, the rest down the attach tree. */
+	void FindComponents(AActor* Actor, TArrayView<const FPathPatternSegment> Segments, TArray<UActorComponent*>& Result);
+	/**
+	 * Answers actor lookups in the levels bound by the persisted index until their tables are built. A miss builds
+	 * that level's table as usual, and levels whose actors change stop using the file.
+	 */
+	void AttachPersisted(TUniquePtr<FPersistedWorldPathIndex> InPersisted);
+	/** Drops every cached table. They are rebuilt on the next lookup. */
+	void Invalidate();
+	/**
+	 * @return A counter for callers caching resolved paths, bumped when a change can make an existing path resolve
+	 * to another object: levels being added or removed, or an actor being destroyed before same-name actors of its level
+	 */
+	uint32 GetGeneration() const;
+
+private:
+	/** Objects bucketed by name in enumeration order, plus the reverse object to same-name index map. */
+	template <typename T>
+	struct TNameTable
+	{
+		TMap<FName, TArray<TWeakObjectPtr<T>, TInlineAllocator<1>>> Buckets;
+		TMap<TObjectKey<T>, int32> Indices;
+		/** Bucket names sorted case-insensitively for prefix queries, rebuilt after a bucket is added or removed */
+		TArray<TPair<FString, FName>> SortedNames;
+		bool bSortedNamesValid = false;
+		/** GFrameCounter of the last build, so lookup misses rebuild the table at most once per frame */
+		uint64 BuildFrame = 0;
+
+		void Add(T* Object);
+		/** @return Whether removing the object changed the same-name index of any other object */
+		bool Remove(T* Object);
+		void Reset();
+		T* Find(FName Name, int32 Index) const;
+		int32 GetIndex(const T* Object) const;
+		void FindMatches(const FPathPatternSegment& Segment, TArray<T*>& Result);
+
+	private:
+		void AppendBucket(FName Name, const FPathPatternSegment& Segment, TArray<T*>& Result) const;
+	};
+
+	struct FActorTable
+	{
+		TNameTable<UActorComponent> Components;
+		/** Component count at the last build, INDEX_NONE until the table is built */
+		int32 NumComponents = INDEX_NONE;
+	};
+
+	void FindAttachChildren(USceneComponent* Parent, const FPathPatternSegment& Segment,
+	                        TArray<UActorComponent*>& Result);
+	void BuildLevels();
+	TNameTable<AActor>& FindOrBuildLevelTable(ULevel* Level);
+	void BuildLevelTable(ULevel* Level, TNameTable<AActor>& Table);
+	FActorTable& FindOrBuildActorTable(AActor* Actor);
+	void BuildActorTable(AActor* Actor, FActorTable& Table);
+	/** Components can be renamed without any notification, so a lookup miss rebuilds the table unless it is this frame's. */
+	bool RebuildActorTableAfterMiss(AActor* Actor, FActorTable& Table);
+
+	void OnActorSpawned(AActor* Actor);
+	void OnActorDestroyed(AActor* Actor);
+	void OnLevelChanged(ULevel* Level, UWorld* InWorld);
+	void OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources);
+
+	TWeakObjectPtr<UWorld> World;
+	TNameTable<ULevel> Levels;
+	bool bLevelsBuilt = false;
+	uint32 Generation = 0;
+	TMap<TObjectKey<ULevel>, TNameTable<AActor>> LevelTables;
+	TMap<TObjectKey<AActor>, FActorTable> ActorTables;
+	TUniquePtr<FPersistedWorldPathIndex> Persisted;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle ActorDestroyedHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+	FDelegateHandle WorldCleanupHandle;
+};
@@ -0,0 +1,181 @@
+﻿#include "FWorldPathTable.h"
+#include "UWorldNavigator.h"
+#include "Components/SceneComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/StringBuilder.h"
+
+FWorldPathId FWorldPathTable::Intern(AActor* Actor)
+{
+	FWorldPathId Id;
+	if (Actor != nullptr)
+	{
+		Id.Value = InternActor(Actor);
+	}
+	return Id;
+}
+
+FWorldPathId FWorldPathTable::Intern(UActorComponent* Component)
+{
+	FWorldPathId Id;
+	if (Component == nullptr or Component->GetComponentLevel() == nullptr)
+	{
+		return Id;
+	}
+	const auto ActorId = Component->GetOwner() != nullptr ? InternActor(Component->GetOwner()) : 0;
+	if (ActorId == 0)
+	{
+		return Id;
+	}
+	const auto SceneComponent = Cast<USceneComponent>(Component);
+	if (SceneComponent == nullptr)
+	{
+		Id.Value = InternSegment(ActorId, Component->GetFName(), UWorldNavigator::GetIndexOfSameComponent(Component),
+		                         ESegmentKind::Component);
+		return Id;
+	}
+	TArray<USceneComponent*, TInlineAllocator<16>> Hierarchy;
+	for (auto Current = SceneComponent; Current != nullptr; Current = Current->GetAttachParent())
+	{
+		Hierarchy.Add(Current);
+	}
+	uint32 Parent = ActorId;
+	for (int32 i = Hierarchy.Num() - 1; i >= 0; --i)
+	{
+		Parent = InternSegment(Parent, Hierarchy[i]->GetFName(), UWorldNavigator::GetIndexOfSameComponent(Hierarchy[i]),
+		                       ESegmentKind::Component);
+	}
+	Id.Value = Parent;
+	return Id;
+}
+
+FWorldPathId FWorldPathTable::Intern(const FCompiledPathStructure& Path)
+{
+	FWorldPathId Id;
+	if (Path.WorldName.IsNone() or Path.LevelName.IsNone() or Path.ActorName.IsNone()
+		or Path.ComponentNames.Num() != Path.ComponentIndices.Num())
+	{
+		return Id;
+	}
+	uint32 Parent = InternSegment(0, Path.WorldName, 0, ESegmentKind::World);
+	Parent = InternSegment(Parent, Path.LevelName, Path.LevelIndex, ESegmentKind::Level);
+	Parent = InternSegment(Parent, Path.ActorName, Path.ActorIndex, ESegmentKind::Actor);
+	for (int32 i = 0; i < Path.ComponentNames.Num(); ++i)
+	{
+		Parent = InternSegment(Parent, Path.ComponentNames[i], Path.ComponentIndices[i], ESegmentKind::Component);
+	}
+	Id.Value = Parent;
+	return Id;
+}
+
+FWorldPathId FWorldPathTable::Intern(FStringView Path)
+{
+	auto ErrorMessage = FString();
+	FCompiledPathStructure CompiledPath;
+	if (!FCompiledPathStructure::TryCompile(Path, ErrorMessage, CompiledPath))
+	{
+		return FWorldPathId();
+	}
+	return Intern(CompiledPath);
+}
+
+FWorldPathId FWorldPathTable::GetParent(FWorldPathId Id) const
+{
+	FWorldPathId Parent;
+	if (Id.IsValid())
+	{
+		Parent.Value = GetNode(Id).Parent;
+	}
+	return Parent;
+}
+
+FString FWorldPathTable::ToString(FWorldPathId Id) const
+{
+	TStringBuilder<256> Builder;
+	AppendTo(Builder, Id);
+	return FString(Builder.Len(), Builder.GetData());
+}
+
+void FWorldPathTable::AppendTo(FStringBuilderBase& Builder, FWorldPathId Id) const
+{
+	if (!Id.IsValid())
+	{
+		Builder << TEXT("[invalid path]");
+		return;
+	}
+	TArray<const FNode*, TInlineAllocator<16>> Segments;
+	for (uint32 Current = Id.Value; Current != 0; Current = Nodes[Current - 1].Parent)
+	{
+		Segments.Add(&Nodes[Current - 1]);
+	}
+	for (int32 i = Segments.Num() - 1; i >= 0; --i)
+	{
+		const FNode& Node = *Segments[i];
+		switch (Node.Kind)
+		{
+		case ESegmentKind::World:
+			Builder << Node.Name;
+			continue;
+		case ESegmentKind::Level:
+			Builder << TEXT('@');
+			break;
+		case ESegmentKind::Actor:
+			Builder << TEXT(":/");
+			break;
+		case ESegmentKind::Component:
+			Builder << (Nodes[Node.Parent - 1].Kind == ESegmentKind::Actor ? TEXT("->") : TEXT("/"));
+			break;
+		}
+		Builder << Node.Name << TEXT('[') << Node.SameNameIndex << TEXT(']');
+	}
+}
+
+int32 FWorldPathTable::Num() const
+{
+	return Nodes.Num();
+}
+
+SIZE_T FWorldPathTable::GetAllocatedSize() const
+{
+	return Nodes.GetAllocatedSize() + NodeIds.GetAllocatedSize();
+}
+
+void FWorldPathTable::Reset()
+{
+	Nodes.Reset();
+	NodeIds.Reset();
+}
+
+uint32 FWorldPathTable::InternSegment(uint32 Parent, FName Name, int32 SameNameIndex, ESegmentKind Kind)
+{
+	const FNodeKey Key{Parent, Name, SameNameIndex};
+	if (const uint32* Existing = NodeIds.Find(Key))
+	{
+		return *Existing;
+	}
+	Nodes.Add({Parent, Name, SameNameIndex, Kind});
+	const uint32 Id = Nodes.Num();
+	NodeIds.Add(Key, Id);
+	return Id;
+}
+
+uint32 FWorldPathTable::InternActor(AActor* Actor)
+{
+	const auto World = Actor->GetWorld();
+	const auto Level = Actor->GetLevel();
+	if (World == nullptr or Level == nullptr)
+	{
+		return 0;
+	}
+	uint32 Parent = InternSegment(0, World->GetFName(), 0, ESegmentKind::World);
+	Parent = InternSegment(Parent, Level->GetFName(), UWorldNavigator::GetIndexOfSameLevel(Level),
+	                       ESegmentKind::Level);
+	return InternSegment(Parent, Actor->GetFName(), UWorldNavigator::GetIndexOfSameActor(Actor), ESegmentKind::Actor);
+}
+
+const FWorldPathTable::FNode& FWorldPathTable::GetNode(FWorldPathId Id) const
+{
+	check(Id.IsValid() and Id.Value <= static_cast<uint32>(Nodes.Num()));
+	return Nodes[Id.Value - 1];
+}
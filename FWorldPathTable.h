@@ -0,0 +1,103 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "FPathStructure.h"
+
+class AActor;
+class UActorComponent;
+class USceneComponent;
+
+/** Handle to a path interned in an FWorldPathTable. Equal handles from the same table mean equal paths. */
+struct FWorldPathId
+{
+	uint32 Value = 0;
+
+	bool IsValid() const
+	{
+		return Value != 0;
+	}
+
+	bool operator==(const FWorldPathId& Other) const
+	{
+		return Value == Other.Value;
+	}
+
+	bool operator!=(const FWorldPathId& Other) const
+	{
+		return Value != Other.Value;
+	}
+
+	friend uint32 GetTypeHash(const FWorldPathId& Id)
+	{
+		return ::GetTypeHash(Id.Value);
+	}
+};
+
+/**
+ * Prefix tree of world paths. Every path segment (world, level, actor, component) is stored once as a
+ * (parent, name, same-name index) node, so millions of paths that share "World@Level[i]:/Actor[j]->" prefixes cost
+ * one node each instead of one string each, and comparing or hashing a path is an integer operation.
+ * Strings are only built by ToString / AppendTo. Not thread-safe.
+ */
+class DEBUGUTILS_API FWorldPathTable
+{
+public:
+	/** @return The id of the actor's path, or an invalid id where GetWorldPath would return an error string */
+	FWorldPathId Intern(AActor* Actor);
+	/** Interns the same path as GetWorldPath, including the attach hierarchy for scene components. */
+	FWorldPathId Intern(UActorComponent* Component);
+	FWorldPathId Intern(const FCompiledPathStructure& Path);
+	/** @return The id of the parsed path, or an invalid id if it does not parse */
+	FWorldPathId Intern(FStringView Path);
+
+	/** @return The path with its last segment removed, or an invalid id for a world or an invalid id */
+	FWorldPathId GetParent(FWorldPathId Id) const;
+	FString ToString(FWorldPathId Id) const;
+	void AppendTo(FStringBuilderBase& Builder, FWorldPathId Id) const;
+
+	int32 Num() const;
+	SIZE_T GetAllocatedSize() const;
+	void Reset();
+
+private:
+	enum class ESegmentKind : uint8
+	{
+		World,
+		Level,
+		Actor,
+		Component
+	};
+
+	struct FNode
+	{
+		uint32 Parent;
+		FName Name;
+		int32 SameNameIndex;
+		ESegmentKind Kind;
+	};
+
+	struct FNodeKey
+	{
+		uint32 Parent;
+		FName Name;
+		int32 SameNameIndex;
+
+		bool operator==(const FNodeKey& Other) const
+		{
+			return Parent == Other.Parent and Name == Other.Name and SameNameIndex == Other.SameNameIndex;
+		}
+
+		friend uint32 GetTypeHash(const FNodeKey& Key)
+		{
+			return HashCombine(HashCombine(::GetTypeHash(Key.Parent), GetTypeHash(Key.Name)),
+			                   ::GetTypeHash(Key.SameNameIndex));
+		}
+	};
+
+	uint32 InternSegment(uint32 Parent, FName Name, int32 SameNameIndex, ESegmentKind Kind);
+	uint32 InternActor(AActor* Actor);
+	const FNode& GetNode(FWorldPathId Id) const;
+
+	/** Node ids are positions in Nodes plus one, so 0 stays free for invalid ids. */
+	TArray<FNode> Nodes;
+	TMap<FNodeKey, uint32> NodeIds;
+};
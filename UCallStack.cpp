@@ -1,36 +1,168 @@
 ﻿#include "UCallStack.h"
+#include "DebugUtilsStats.h"
+#include "FCallSiteProfiler.h"
+#include "FSymbolCache.h"
 #include "Engine/Engine.h"
 #include "Engine/World.h"
 #include "Components/SceneComponent.h"
 #include "DrawDebugHelpers.h"
 #include "HAL/PlatformStackWalk.h"
 #include "Misc/OutputDeviceRedirector.h"
+#include "Misc/StringBuilder.h"
+#include "UObject/Stack.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#if WITH_EDITORONLY_DATA
+#include "EdGraph/EdGraphNode.h"
+#endif
 
-FString UCallStack::GetCallerName()
+FORCENOINLINE FString UCallStack::GetCallerName()
 {
 	// I set the IgnoreCount to 1 to ignore this function.
-	TArray<FProgramCounterSymbolInfo> CurrentInfo = FPlatformStackWalk::GetStack(1, 1, nullptr);
-	if (CurrentInfo.Num() == 0)
+	FCachedSymbolInfo CurrentInfo;
+	if (!FSymbolCache::Get().Resolve(FSymbolCache::CaptureProgramCounter(1), CurrentInfo))
 	{
 		return TEXT("[unknown]");
 	}
-	const FString CallerInfo = CurrentInfo[0].FunctionName;
-	// Trim the trailing parenthesis pair
-	return CallerInfo.LeftChop(2);
+	return CurrentInfo.GetSanitizedFunctionName();
 }
 
-FString UCallStack::GetCallerInfo()
+DEFINE_FUNCTION(UCallStack::execGetCallerName)
+{
+	P_FINISH;
+	P_NATIVE_BEGIN;
+	*static_cast<FString*>(RESULT_PARAM) = IsScriptFrame(Stack) ? GetScriptCallerName(Stack) : GetCallerName();
+	P_NATIVE_END;
+}
+
+FORCENOINLINE FString UCallStack::GetCallerInfo()
 {
 	// I set the IgnoreCount to 1 to ignore this function.
-	TArray<FProgramCounterSymbolInfo> CurrentInfo = FPlatformStackWalk::GetStack(1, 1, nullptr);
-	if (CurrentInfo.Num() == 0)
+	FCachedSymbolInfo CurrentInfo;
+	if (!FSymbolCache::Get().Resolve(FSymbolCache::CaptureProgramCounter(1), CurrentInfo))
 	{
 		return TEXT("[unknown]");
 	}
-	const FString CallerFile = CurrentInfo[0].Filename;
-	const FString CallerInfo = CurrentInfo[0].FunctionName;
-	const FString CallerNameSanitized = CallerInfo.LeftChop(2);
-	const FString CallerLine = FString::Printf(TEXT("%d"), CurrentInfo[0].LineNumber);
-	// Trim the trailing parenthesis pair
-	return FString::Printf(TEXT("%s@%s:%s"), *CallerFile, *CallerNameSanitized, *CallerLine);
+	return CurrentInfo.ToString();
+}
+
+DEFINE_FUNCTION(UCallStack::execGetCallerInfo)
+{
+	P_FINISH;
+	P_NATIVE_BEGIN;
+	*static_cast<FString*>(RESULT_PARAM) = IsScriptFrame(Stack) ? GetScriptCallerInfo(Stack) : GetCallerInfo();
+	P_NATIVE_END;
+}
+
+FORCENOINLINE FDeferredCallStackHandle UCallStack::GetDeferredCaller(int32 Depth)
+{
+	// I set the IgnoreCount to 1 to ignore this function.
+	return FDeferredCallStack::Record(Depth, 1);
+}
+
+FString UCallStack::ResolveDeferredCaller(FDeferredCallStackHandle Handle)
+{
+	return FDeferredCallStack::Resolve(Handle);
+}
+
+FORCENOINLINE FCallStackSnapshot UCallStack::CaptureStack(int32 Depth, int32 Skip)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_CaptureStack);
+	FCallStackSnapshot Snapshot;
+	if (Depth <= 0)
+	{
+		return Snapshot;
+	}
+	// I add 1 to the IgnoreCount to ignore this function. Capturing through FSymbolCache goes through the same helper
+	// frame as GetCallerName, so frame 0 is the same caller for every UCallStack function.
+	const int32 IgnoreCount = FMath::Max(Skip, 0) + 1;
+	Snapshot.ProgramCounters.SetNumZeroed(IgnoreCount + Depth);
+	const int32 CapturedDepth = FSymbolCache::CaptureBackTrace(Snapshot.ProgramCounters.GetData(),
+	                                                           Snapshot.ProgramCounters.Num());
+	Snapshot.ProgramCounters.SetNum(FMath::Max(CapturedDepth, IgnoreCount), EAllowShrinking::No);
+	Snapshot.ProgramCounters.RemoveAt(0, IgnoreCount, EAllowShrinking::No);
+	return Snapshot;
+}
+
+FString UCallStack::FormatStack(const FCallStackSnapshot& Snapshot)
+{
+	TStringBuilder<1024> Builder;
+	FormatStackTo(Builder, Snapshot);
+	return Builder.Len() > 0 ? FString(Builder.Len(), Builder.GetData()) : FString(TEXT("[unknown]"));
+}
+
+void UCallStack::FormatStackTo(FStringBuilderBase& Builder, const FCallStackSnapshot& Snapshot)
+{
+	FSymbolCache& SymbolCache = FSymbolCache::Get();
+	FCachedSymbolInfo SymbolInfo;
+	bool bFirstFrame = true;
+	for (const uint64 ProgramCounter : Snapshot.ProgramCounters)
+	{
+		if (!SymbolCache.Resolve(ProgramCounter, SymbolInfo))
+		{
+			continue;
+		}
+		if (!bFirstFrame)
+		{
+			Builder << TEXT('\n');
+		}
+		bFirstFrame = false;
+		Builder << SymbolInfo.Filename << TEXT('@') << SymbolInfo.GetSanitizedFunctionName() << TEXT(':')
+			<< SymbolInfo.LineNumber;
+	}
+}
+
+FORCENOINLINE void UCallStack::RecordCallSite()
+{
+	// I set the IgnoreCount to 1 to ignore this function.
+	const uint64 ProgramCounter = FSymbolCache::CaptureProgramCounter(1);
+	if (ProgramCounter != 0)
+	{
+		FCallSiteProfiler::RecordHit(ProgramCounter);
+	}
+}
+
+FString UCallStack::FormatCallerInfo(const ANSICHAR* File, const ANSICHAR* Function, int32 Line)
+{
+	return FString::Printf(TEXT("%s@%s:%d"), ANSI_TO_TCHAR(File), ANSI_TO_TCHAR(Function), Line);
+}
+
+bool UCallStack::IsScriptFrame(const FFrame& Stack)
+{
+	// From bytecode, Stack is the calling function's frame; from ProcessEvent it is a frame for the native function itself.
+	return Stack.Node != nullptr and !Stack.Node->HasAnyFunctionFlags(FUNC_Native) and Stack.Code != nullptr;
+}
+
+FString UCallStack::GetScriptCallerName(const FFrame& Stack)
+{
+	const UClass* OwnerClass = Stack.Node->GetOwnerClass();
+	if (OwnerClass == nullptr)
+	{
+		return Stack.Node->GetName();
+	}
+	return FString::Printf(TEXT("%s::%s"), *OwnerClass->GetName(), *Stack.Node->GetName());
+}
+
+FString UCallStack::GetScriptCallerInfo(const FFrame& Stack)
+{
+	const UClass* OwnerClass = Stack.Node->GetOwnerClass();
+	const FString BlueprintPath = OwnerClass != nullptr ? OwnerClass->GetPathName() : Stack.Node->GetPathName();
+	// Code already points past the call instruction, so step back into it.
+	const int32 CodeOffset = static_cast<int32>(Stack.Code - Stack.Node->Script.GetData()) - 1;
+#if WITH_EDITORONLY_DATA
+	if (const UBlueprintGeneratedClass* BlueprintClass = Cast<UBlueprintGeneratedClass>(OwnerClass))
+	{
+		UFunction* Function = Stack.Node;
+		if (const UEdGraphNode* SourceNode = BlueprintClass->DebugData.FindSourceNodeFromCodeLocation(
+			Function, CodeOffset, true))
+		{
+#if WITH_EDITOR
+			const FString NodeName = SourceNode->GetNodeTitle(ENodeTitleType::ListView).ToString();
+#else
+			const FString NodeName = SourceNode->GetName();
+#endif
+			return FString::Printf(TEXT("%s@%s:%s"), *BlueprintPath, *GetScriptCallerName(Stack), *NodeName);
+		}
+	}
+#endif
+	return FString::Printf(TEXT("%s@%s:%d"), *BlueprintPath, *GetScriptCallerName(Stack), CodeOffset);
 }
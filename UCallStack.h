@@ -1,4 +1,6 @@
 ﻿#pragma once
+#include "FCallStackSnapshot.h"
+#include "FDeferredCallStack.h"
 #include "UCallStack.generated.h"
 
 UCLASS(BlueprintType, Blueprintable)
@@ -10,16 +12,89 @@ public:
 	/**
 	 * Retrieves information about the calling function using stack trace inspection.
 	 * Useful for debugging and logging to identify which function initiated a call.
+	 * Blueprint calls are resolved from the script frame instead, giving the calling Blueprint function.
 	 * @return A string representing the calling function, or "[unknown]" if unavailable
 	 */
-	UFUNCTION(BlueprintCallable, Category = "Call Stack")
+	UFUNCTION(BlueprintCallable, CustomThunk, Category = "Call Stack")
 	static FString GetCallerName();
+	DECLARE_FUNCTION(execGetCallerName);
 
 	/**
 	 * Retrieves detailed stack trace information including file path and line number.
 	 * Provides more comprehensive debug info than GetCallerName for deeper analysis.
+	 * Blueprint calls report the Blueprint asset, the calling function and the calling node (in editor builds)
+	 * or the bytecode offset of the call, read from the script frame without a native stack walk.
 	 * @return A formatted string with file, line, and function details, or "[unknown]" if unavailable
 	 */
-	UFUNCTION(BlueprintCallable, Category = "Call Stack")
+	UFUNCTION(BlueprintCallable, CustomThunk, Category = "Call Stack")
 	static FString GetCallerInfo();
+	DECLARE_FUNCTION(execGetCallerInfo);
+
+	/**
+	 * Deferred variant of GetCallerInfo for tracing: records only the caller's return addresses into a per-thread
+	 * ring buffer and returns a handle, leaving symbolization to ResolveDeferredCaller or FDeferredCallStack::ResolveAsync.
+	 * @param Depth The number of frames to record, starting at the caller
+	 */
+	static FDeferredCallStackHandle GetDeferredCaller(int32 Depth = 1);
+
+	/**
+	 * Symbolizes a handle returned by GetDeferredCaller.
+	 * @return One "File@Function:Line" line per frame, or "[unknown]" if the handle went stale
+	 */
+	static FString ResolveDeferredCaller(FDeferredCallStackHandle Handle);
+
+	/**
+	 * Captures the raw return addresses of the current stack without symbolizing them.
+	 * @param Depth The maximum number of frames to capture
+	 * @param Skip The number of frames to skip, 0 starting at the function calling CaptureStack
+	 */
+	static FCallStackSnapshot CaptureStack(int32 Depth = FCallStackSnapshot::InlineFrames, int32 Skip = 0);
+
+	/**
+	 * Symbolizes a snapshot through the shared symbol cache.
+	 * @return One "File@Function:Line" line per frame, or "[unknown]" if no frame could be symbolized
+	 */
+	static FString FormatStack(const FCallStackSnapshot& Snapshot);
+	/** Appends one "File@Function:Line" line per frame of the snapshot to Builder */
+	static void FormatStackTo(FStringBuilderBase& Builder, const FCallStackSnapshot& Snapshot);
+
+	/**
+	 * Counts one hit for the function calling RecordCallSite in FCallSiteProfiler, using the same caller capture
+	 * as GetCallerInfo but without symbolizing. Costs a stack capture and a thread-local counter increment.
+	 */
+	static void RecordCallSite();
+
+	/**
+	 * Formats a source location like GetCallerInfo does. Used by UE_CALLER_INFO.
+	 * @return "File@Function:Line"
+	 */
+	static FString FormatCallerInfo(const ANSICHAR* File, const ANSICHAR* Function, int32 Line);
+
+private:
+	/** @return Whether the thunk was reached from Blueprint bytecode rather than a native ProcessEvent call */
+	static bool IsScriptFrame(const FFrame& Stack);
+	/** @return "BlueprintClass::Function" for the script function executing the call */
+	static FString GetScriptCallerName(const FFrame& Stack);
+	/** @return "BlueprintPath@BlueprintClass::Function:Node" for the script function and node executing the call */
+	static FString GetScriptCallerInfo(const FFrame& Stack);
 };
+
+/**
+ * Compile-time counterparts of GetCallerInfo and GetCallerName for C++ code: they describe the location where the macro
+ * is written, in the same format, without walking the stack. The string is built once per macro site and then returned
+ * by reference, so repeated calls cost a guard check.
+ * The function name comes from __FUNCTION__, which is the qualified name on MSVC and the unqualified one on Clang.
+ */
+#define UE_CALLER_INFO() \
+	([](const ANSICHAR* File, const ANSICHAR* Function, int32 Line) -> const FString& \
+	{ \
+		static const FString CallerInfo = UCallStack::FormatCallerInfo(File, Function, Line); \
+		return CallerInfo; \
+	}(__FILE__, __FUNCTION__, __LINE__))
+
+#define UE_CALLER_NAME() \
+	([](const ANSICHAR* Function) -> const FString& \
+	{ \
+		static const FString CallerName(Function); \
+		return CallerName; \
+	}(__FUNCTION__))
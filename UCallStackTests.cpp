@@ -0,0 +1,42 @@
+﻿#include "UCallStack.h"
+#include "FSymbolCache.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	FORCENOINLINE FCallStackSnapshot CaptureCallerOfThisFunction()
+	{
+		return UCallStack::CaptureStack(1, 1);
+	}
+
+	FString GetFrameFunctionName(const FCallStackSnapshot& Snapshot)
+	{
+		FCachedSymbolInfo SymbolInfo;
+		if (Snapshot.IsEmpty() or !FSymbolCache::Get().Resolve(Snapshot.ProgramCounters[0], SymbolInfo))
+		{
+			return TEXT("[unknown]");
+		}
+		return SymbolInfo.GetSanitizedFunctionName();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCallStackCaptureMatchesCallerNameTest,
+                                 "DebugUtils.CallStack.CaptureStackMatchesGetCallerName",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+                                 | EAutomationTestFlags::EngineFilter)
+
+bool FCallStackCaptureMatchesCallerNameTest::RunTest(const FString& Parameters)
+{
+	// Frame 0 of CaptureStack and the frame GetCallerName reports must both be this function.
+	const FCallStackSnapshot Snapshot = UCallStack::CaptureStack(1, 0);
+	const FString CallerName = UCallStack::GetCallerName();
+	TestEqual(TEXT("Captured frames"), Snapshot.Num(), 1);
+	TestEqual(TEXT("CaptureStack(1, 0) frame 0"), GetFrameFunctionName(Snapshot), CallerName);
+	// Skipping one frame from a helper lands on the helper's caller, which is this function again.
+	TestEqual(TEXT("CaptureStack(1, 1) frame 0"), GetFrameFunctionName(CaptureCallerOfThisFunction()), CallerName);
+	return true;
+}
+
+#endif
@@ -3,74 +3,719 @@
 #include "Containers/Array.h"
 #include "Containers/Map.h"
 #include "Containers/Set.h"
+#include "Misc/StringBuilder.h"
+#include "DebugUtilsStats.h"
+#include "UReprReflection.h"
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
 
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define UE_REPR_FLOAT_TO_CHARS 1
+#else
+#define UE_REPR_FLOAT_TO_CHARS 0
+#endif
+
+/**
+ * Limits for formatting huge containers. Once a limit is hit, formatting stops with a "..." marker,
+ * so the cost stays proportional to the output budget rather than to the container size.
+ */
+struct FReprOptions
+{
+	/** Elements printed per container before the rest is replaced with "..." */
+	int32 MaxElements = MAX_int32;
+	/** Container nesting levels printed before deeper containers are replaced with "[...]" or "{...}" */
+	int32 MaxDepth = MAX_int32;
+	/**
+	 * Builder length, in characters (TCHARs, not UTF-8 bytes), after which containers stop adding elements and
+	 * strings are cut short with "..."
+	 */
+	int32 MaxOutputLength = MAX_int32;
+
+	/** @return The options for the elements of a container formatted with these options */
+	FReprOptions Descend() const
+	{
+		FReprOptions Result = *this;
+		Result.MaxDepth -= 1;
+		return Result;
+	}
+
+	/** @return Whether a container must stop before printing the element at ElementIndex */
+	bool IsExhausted(const FStringBuilderBase& Builder, int32 ElementIndex) const
+	{
+		return ElementIndex >= MaxElements or Builder.Len() >= MaxOutputLength;
+	}
+
+	/** Appends Text, cut to the characters left before MaxOutputLength and followed by "..." when it does not fit. */
+	void AppendBounded(FStringBuilderBase& Builder, FStringView Text) const
+	{
+		const int32 Remaining = MaxOutputLength - Builder.Len();
+		if (Text.Len() <= Remaining)
+		{
+			Builder << Text;
+			return;
+		}
+		Builder << Text.Left(FMath::Max(Remaining, 0)) << TEXT("...");
+	}
+};
+
+/**
+ * Customization point for formatting a type. Specialize it with a static
+ * `void Format(FStringBuilderBase&, const T&, const FReprOptions&)` to make T printable by Repr, ReprTo and every
+ * container overload. Because the trait is looked up by its qualified name, no overload resolution or ADL is
+ * involved, so the specialization wins regardless of the namespace T lives in or of what headers are included.
+ * Types whose output has a known upper bound also declare `static constexpr int32 MaxLength`, which lets the
+ * containers reserve the builder once for all their elements.
+ */
+template <typename T, typename = void>
+struct TReprFormatter
+{
+};
+
+template <typename T, typename = void>
+struct THasReprFormatter : std::false_type
+{
+};
+
+template <typename T>
+struct THasReprFormatter<T, std::void_t<decltype(&TReprFormatter<T>::Format)>> : std::true_type
+{
+};
+
+/** Upper bound of the characters Repr writes for any value of T, or INDEX_NONE when it is not bounded. */
+template <typename T, typename = void>
+struct TReprMaxLength
+{
+	static constexpr int32 Value = INDEX_NONE;
+};
+
+template <typename T>
+struct TReprMaxLength<T, std::void_t<decltype(TReprFormatter<T>::MaxLength)>>
+{
+	static constexpr int32 Value = TReprFormatter<T>::MaxLength;
+};
+
+/**
+ * Formats Value as a string. Containers have dedicated overloads below; any other type must have a TReprFormatter,
+ * be a USTRUCT or a UObject pointer, or provide its own Repr specialization or ReprTo overload.
+ */
 template <typename T>
 FString Repr(const T& Value);
 
+/**
+ * Appends the representation of Value to Builder. Every Repr overload is layered on this family,
+ * so nested containers are written into one buffer instead of allocating a string per element.
+ * Types with a TReprFormatter use it, USTRUCTs and UObject pointers are formatted through reflection,
+ * and other types that only provide a Repr specialization fall back to it.
+ */
+template <typename T>
+void ReprTo(FStringBuilderBase& Builder, const T& Value, const FReprOptions& Options = FReprOptions())
+{
+	if constexpr (THasReprFormatter<T>::value)
+	{
+		TReprFormatter<T>::Format(Builder, Value, Options);
+	}
+	else if constexpr (TIsReprReflected<T>::value)
+	{
+		FReprReflection::StructTo(Builder, TBaseStructure<T>::Get(), &Value, Options);
+	}
+	else if constexpr (TIsReprObjectPointer<T>::value)
+	{
+		FReprReflection::ObjectTo(Builder, Value, Options);
+	}
+	else
+	{
+		Options.AppendBounded(Builder, Repr(Value));
+	}
+}
+
+namespace ReprPrivate
+{
+	/** Longest text WriteInteger or WriteFloat writes for T, suffix excluded. */
+	template <typename T>
+	struct TMaxNumberLength
+	{
+		// Sign, digits, and for floating point the decimal point plus an exponent such as "e-308" or a ".0".
+		static constexpr int32 Value = std::numeric_limits<T>::is_integer
+			                               ? std::numeric_limits<T>::digits10 + 2
+			                               : std::numeric_limits<T>::max_digits10 + 8;
+	};
+
+	/**
+	 * Grows the builder once for a container of Num elements of at most ElementLength characters each,
+	 * so appending the elements never reallocates. The reservation honours the element and output limits.
+	 */
+	inline void ReserveElements(FStringBuilderBase& Builder, int32 Num, int32 ElementLength, const FReprOptions& Options)
+	{
+		// Brackets plus a ", ..." tail, and a separator per element.
+		const int64 Count = FMath::Min(Num, Options.MaxElements);
+		int64 Length = 7 + Count * (ElementLength + 2);
+		if (Options.MaxOutputLength != MAX_int32)
+		{
+			Length = FMath::Min<int64>(Length, static_cast<int64>(Options.MaxOutputLength) - Builder.Len() + ElementLength + 7);
+		}
+		if (Length <= 0 or Length > MAX_int32)
+		{
+			return;
+		}
+		Builder.AddUninitialized(static_cast<int32>(Length));
+		Builder.RemoveSuffix(static_cast<int32>(Length));
+	}
+
+	/** Two-digit lookup table: the integer writer emits a pair of digits per division instead of one. */
+	inline constexpr ANSICHAR DigitPairs[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+		"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+
+	inline TCHAR* WriteLiteral(TCHAR* Out, const TCHAR* Literal)
+	{
+		while (*Literal != TEXT('\0'))
+		{
+			*Out++ = *Literal++;
+		}
+		return Out;
+	}
+
+	/** Writes the decimal digits of Value to Out, without a format string. @return The end of the written text */
+	template <typename IntType>
+	TCHAR* WriteInteger(TCHAR* Out, IntType Value)
+	{
+		using FUnsigned = std::make_unsigned_t<IntType>;
+		FUnsigned Magnitude = static_cast<FUnsigned>(Value);
+		if constexpr (std::is_signed_v<IntType>)
+		{
+			if (Value < 0)
+			{
+				*Out++ = TEXT('-');
+				Magnitude = static_cast<FUnsigned>(FUnsigned(0) - Magnitude);
+			}
+		}
+		TCHAR Digits[24];
+		TCHAR* const DigitsEnd = Digits + UE_ARRAY_COUNT(Digits);
+		TCHAR* First = DigitsEnd;
+		while (Magnitude >= 100)
+		{
+			const uint32 Pair = static_cast<uint32>(Magnitude % 100) * 2;
+			Magnitude /= 100;
+			*--First = static_cast<TCHAR>(DigitPairs[Pair + 1]);
+			*--First = static_cast<TCHAR>(DigitPairs[Pair]);
+		}
+		if (Magnitude >= 10)
+		{
+			const uint32 Pair = static_cast<uint32>(Magnitude) * 2;
+			*--First = static_cast<TCHAR>(DigitPairs[Pair + 1]);
+			*--First = static_cast<TCHAR>(DigitPairs[Pair]);
+		}
+		else
+		{
+			*--First = static_cast<TCHAR>(TEXT('0') + Magnitude);
+		}
+		while (First != DigitsEnd)
+		{
+			*Out++ = *First++;
+		}
+		return Out;
+	}
+
+	/**
+	 * Writes the shortest decimal that reads back as exactly Value, e.g. 0.1f as "0.1" instead of "0.100000".
+	 * A ".0" is added to integral values so they still read as floating point.
+	 */
+	template <typename FloatType>
+	TCHAR* WriteFloat(TCHAR* Out, FloatType Value)
+	{
+		ANSICHAR Buffer[48];
+#if UE_REPR_FLOAT_TO_CHARS
+		const ANSICHAR* End = std::to_chars(Buffer, Buffer + UE_ARRAY_COUNT(Buffer), Value).ptr;
+#else
+		// Standard libraries without floating point to_chars: take the fewest %g digits that round-trip.
+		constexpr int32 MaxDigits = std::numeric_limits<FloatType>::max_digits10;
+		int32 Length = 0;
+		for (int32 Digits = 1; Digits <= MaxDigits; ++Digits)
+		{
+			Length = std::snprintf(Buffer, UE_ARRAY_COUNT(Buffer), "%.*g", Digits, static_cast<double>(Value));
+			if (static_cast<FloatType>(std::strtod(Buffer, nullptr)) == Value or Value != Value)
+			{
+				break;
+			}
+		}
+		const ANSICHAR* End = Buffer + Length;
+#endif
+		bool bLooksIntegral = true;
+		for (const ANSICHAR* Char = Buffer; Char != End; ++Char)
+		{
+			if (*Char == '.' or *Char == 'e' or *Char == 'n' or *Char == 'i')
+			{
+				bLooksIntegral = false;
+			}
+			*Out++ = static_cast<TCHAR>(*Char);
+		}
+		if (bLooksIntegral)
+		{
+			*Out++ = TEXT('.');
+			*Out++ = TEXT('0');
+		}
+		return Out;
+	}
+
+	template <typename T, typename = void>
+	struct THasWriter : std::false_type
+	{
+	};
+
+	/** Formatters with a bounded length may also provide `static TCHAR* Write(TCHAR* Out, const T&)`. */
+	template <typename T>
+	struct THasWriter<T, std::void_t<decltype(&TReprFormatter<T>::Write), decltype(TReprFormatter<T>::MaxLength)>>
+		: std::true_type
+	{
+	};
+
+	/** Formats Value through its formatter's Write into a stack buffer and appends it with one copy. */
+	template <typename T>
+	void AppendWritten(FStringBuilderBase& Builder, const T& Value)
+	{
+		TCHAR Buffer[TReprFormatter<T>::MaxLength];
+		Builder.Append(Buffer, static_cast<int32>(TReprFormatter<T>::Write(Buffer, Value) - Buffer));
+	}
+
+	/**
+	 * Bulk path for contiguous arrays of types with a Write: elements are written straight into the builder's
+	 * storage, grown once per chunk by the bounded element length, instead of going through a builder append per
+	 * element. The output and the FReprOptions limits are the same as the per-element path.
+	 */
+	template <typename T>
+	void AppendWrittenElements(FStringBuilderBase& Builder, const T* Values, int32 Num, const FReprOptions& Options)
+	{
+		// Separator plus element, and room for the ", ..." marker.
+		constexpr int32 ElementLength = TReprFormatter<T>::MaxLength + 2;
+		constexpr int32 ChunkSize = FMath::Max(1, 65536 / ElementLength);
+		for (int32 ChunkStart = 0; ChunkStart < Num; ChunkStart += ChunkSize)
+		{
+			const int32 ChunkEnd = FMath::Min(Num, ChunkStart + ChunkSize);
+			const int32 Reserved = (ChunkEnd - ChunkStart) * ElementLength + 5;
+			const int32 Start = Builder.Len();
+			Builder.AddUninitialized(Reserved);
+			TCHAR* const Begin = Builder.GetData() + Start;
+			TCHAR* Out = Begin;
+			bool bExhausted = false;
+			for (int32 i = ChunkStart; i < ChunkEnd; ++i)
+			{
+				if (i > 0)
+				{
+					*Out++ = TEXT(',');
+					*Out++ = TEXT(' ');
+				}
+				if (i >= Options.MaxElements or Start + (Out - Begin) >= Options.MaxOutputLength)
+				{
+					Out = WriteLiteral(Out, TEXT("..."));
+					bExhausted = true;
+					break;
+				}
+				Out = TReprFormatter<T>::Write(Out, Values[i]);
+			}
+			Builder.RemoveSuffix(Reserved - static_cast<int32>(Out - Begin));
+			if (bExhausted)
+			{
+				return;
+			}
+		}
+	}
+}
+
+/** Formats Value through ReprTo into an inline-storage builder and copies the result out once. */
+template <typename T>
+FString ReprViaBuilder(const T& Value, const FReprOptions& Options = FReprOptions())
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_FormatRepr);
+	TStringBuilder<256> Builder;
+	ReprTo(Builder, Value, Options);
+	DEBUGUTILS_COUNTER_ADD(STAT_DebugUtils_ReprBytes, Builder.Len() * sizeof(TCHAR));
+	return FString(Builder.Len(), Builder.GetData());
+}
+
+#define UE_REPR_NUMERIC_FORMATTER(Type, WriteFunction, SuffixLiteral) \
+	template <> \
+	struct TReprFormatter<Type> \
+	{ \
+		static constexpr TCHAR Suffix[] = TEXT(SuffixLiteral); \
+		static constexpr int32 MaxLength = ReprPrivate::TMaxNumberLength<Type>::Value + UE_ARRAY_COUNT(Suffix) - 1; \
+		static TCHAR* Write(TCHAR* Out, const Type& Value) \
+		{ \
+			return ReprPrivate::WriteLiteral(ReprPrivate::WriteFunction(Out, Value), Suffix); \
+		} \
+		static void Format(FStringBuilderBase& Builder, const Type& Value, const FReprOptions& Options) \
+		{ \
+			ReprPrivate::AppendWritten(Builder, Value); \
+		} \
+	};
+
+UE_REPR_NUMERIC_FORMATTER(int8, WriteInteger, "_i8")
+UE_REPR_NUMERIC_FORMATTER(int16, WriteInteger, "_i16")
+UE_REPR_NUMERIC_FORMATTER(int32, WriteInteger, "_i32")
+UE_REPR_NUMERIC_FORMATTER(int64, WriteInteger, "_i64")
+UE_REPR_NUMERIC_FORMATTER(uint8, WriteInteger, "_u8")
+UE_REPR_NUMERIC_FORMATTER(uint16, WriteInteger, "_u16")
+UE_REPR_NUMERIC_FORMATTER(uint32, WriteInteger, "_u32")
+UE_REPR_NUMERIC_FORMATTER(uint64, WriteInteger, "_u64")
+UE_REPR_NUMERIC_FORMATTER(float, WriteFloat, "_f32")
+UE_REPR_NUMERIC_FORMATTER(double, WriteFloat, "_f64")
+
+#undef UE_REPR_NUMERIC_FORMATTER
+
+template <>
+struct TReprFormatter<bool>
+{
+	static constexpr int32 MaxLength = 5;
+
+	static void Format(FStringBuilderBase& Builder, const bool& Value, const FReprOptions& Options)
+	{
+		Builder << (Value ? TEXT("true") : TEXT("false"));
+	}
+};
+
+template <>
+struct TReprFormatter<FString>
+{
+	static void Format(FStringBuilderBase& Builder, const FString& Value, const FReprOptions& Options)
+	{
+		Builder << TEXT('"');
+		Options.AppendBounded(Builder, Value);
+		Builder << TEXT('"');
+	}
+};
+
+template <>
+struct TReprFormatter<FName>
+{
+	static void Format(FStringBuilderBase& Builder, const FName& Value, const FReprOptions& Options)
+	{
+		Value.AppendString(Builder);
+	}
+};
+
+template <>
+struct TReprFormatter<FText>
+{
+	static void Format(FStringBuilderBase& Builder, const FText& Value, const FReprOptions& Options)
+	{
+		Options.AppendBounded(Builder, Value.ToString());
+	}
+};
+
+/** Same text as the reflected form, e.g. "FVector(X=1.0_f64, Y=2.0_f64, Z=3.0_f64)", without the property walk. */
+template <>
+struct TReprFormatter<FVector>
+{
+	using FComponent = TReprFormatter<decltype(FVector::X)>;
+	// "FVector(X=", ", Y=", ", Z=" and ")"
+	static constexpr int32 MaxLength = 19 + 3 * FComponent::MaxLength;
+
+	static TCHAR* Write(TCHAR* Out, const FVector& Value)
+	{
+		Out = FComponent::Write(ReprPrivate::WriteLiteral(Out, TEXT("FVector(X=")), Value.X);
+		Out = FComponent::Write(ReprPrivate::WriteLiteral(Out, TEXT(", Y=")), Value.Y);
+		Out = FComponent::Write(ReprPrivate::WriteLiteral(Out, TEXT(", Z=")), Value.Z);
+		return ReprPrivate::WriteLiteral(Out, TEXT(")"));
+	}
+
+	static void Format(FStringBuilderBase& Builder, const FVector& Value, const FReprOptions& Options)
+	{
+		ReprPrivate::AppendWritten(Builder, Value);
+	}
+};
+
+template <>
+struct TReprFormatter<FRotator>
+{
+	using FComponent = TReprFormatter<decltype(FRotator::Pitch)>;
+	// "FRotator(Pitch=", ", Yaw=", ", Roll=" and ")"
+	static constexpr int32 MaxLength = 29 + 3 * FComponent::MaxLength;
+
+	static TCHAR* Write(TCHAR* Out, const FRotator& Value)
+	{
+		Out = FComponent::Write(ReprPrivate::WriteLiteral(Out, TEXT("FRotator(Pitch=")), Value.Pitch);
+		Out = FComponent::Write(ReprPrivate::WriteLiteral(Out, TEXT(", Yaw=")), Value.Yaw);
+		Out = FComponent::Write(ReprPrivate::WriteLiteral(Out, TEXT(", Roll=")), Value.Roll);
+		return ReprPrivate::WriteLiteral(Out, TEXT(")"));
+	}
+
+	static void Format(FStringBuilderBase& Builder, const FRotator& Value, const FReprOptions& Options)
+	{
+		ReprPrivate::AppendWritten(Builder, Value);
+	}
+};
+
+template <>
+struct TReprFormatter<FQuat>
+{
+	using FComponent = TReprFormatter<decltype(FQuat::X)>;
+	// "FQuat(X=", ", Y=", ", Z=", ", W=" and ")"
+	static constexpr int32 MaxLength = 21 + 4 * FComponent::MaxLength;
+
+	static TCHAR* Write(TCHAR* Out, const FQuat& Value)
+	{
+		Out = FComponent::Write(ReprPrivate::WriteLiteral(Out, TEXT("FQuat(X=")), Value.X);
+		Out = FComponent::Write(ReprPrivate::WriteLiteral(Out, TEXT(", Y=")), Value.Y);
+		Out = FComponent::Write(ReprPrivate::WriteLiteral(Out, TEXT(", Z=")), Value.Z);
+		Out = FComponent::Write(ReprPrivate::WriteLiteral(Out, TEXT(", W=")), Value.W);
+		return ReprPrivate::WriteLiteral(Out, TEXT(")"));
+	}
+
+	static void Format(FStringBuilderBase& Builder, const FQuat& Value, const FReprOptions& Options)
+	{
+		ReprPrivate::AppendWritten(Builder, Value);
+	}
+};
+
+template <>
+struct TReprFormatter<FTransform>
+{
+	// "FTransform(Rotation=", ", Translation=", ", Scale3D=" and ")"
+	static constexpr int32 MaxLength = 45 + TReprFormatter<FQuat>::MaxLength + 2 * TReprFormatter<FVector>::MaxLength;
+
+	static TCHAR* Write(TCHAR* Out, const FTransform& Value)
+	{
+		Out = ReprPrivate::WriteLiteral(Out, TEXT("FTransform(Rotation="));
+		Out = TReprFormatter<FQuat>::Write(Out, Value.GetRotation());
+		Out = ReprPrivate::WriteLiteral(Out, TEXT(", Translation="));
+		Out = TReprFormatter<FVector>::Write(Out, Value.GetTranslation());
+		Out = ReprPrivate::WriteLiteral(Out, TEXT(", Scale3D="));
+		Out = TReprFormatter<FVector>::Write(Out, Value.GetScale3D());
+		return ReprPrivate::WriteLiteral(Out, TEXT(")"));
+	}
+
+	static void Format(FStringBuilderBase& Builder, const FTransform& Value, const FReprOptions& Options)
+	{
+		ReprPrivate::AppendWritten(Builder, Value);
+	}
+};
+
 template <typename T, typename U>
-FString Repr(const TPair<T, U>& Pair)
+struct TReprMaxLength<TPair<T, U>>
+{
+	static constexpr int32 Value = TReprMaxLength<T>::Value == INDEX_NONE or TReprMaxLength<U>::Value == INDEX_NONE
+		                               ? INDEX_NONE
+		                               : TReprMaxLength<T>::Value + TReprMaxLength<U>::Value + 4;
+};
+
+template <typename T>
+struct TReprMaxLength<TOptional<T>>
+{
+	static constexpr int32 Value = TReprMaxLength<T>::Value == INDEX_NONE ? INDEX_NONE : TReprMaxLength<T>::Value + 6;
+};
+
+template <typename... Types>
+struct TReprMaxLength<TTuple<Types...>>
+{
+	static constexpr int32 Value = ((TReprMaxLength<Types>::Value == INDEX_NONE) or ...)
+		                               ? INDEX_NONE
+		                               : (2 + ... + (TReprMaxLength<Types>::Value + 2));
+};
+
+template <typename T, typename U>
+void ReprTo(FStringBuilderBase& Builder, const TPair<T, U>& Pair, const FReprOptions& Options = FReprOptions())
+{
+	Builder << TEXT('(');
+	ReprTo(Builder, Pair.Key, Options);
+	Builder << TEXT(", ");
+	ReprTo(Builder, Pair.Value, Options);
+	Builder << TEXT(')');
+}
+
+template <typename T>
+void ReprTo(FStringBuilderBase& Builder, const TArray<T>& Array, const FReprOptions& Options = FReprOptions())
+{
+	if (Options.MaxDepth <= 0)
+	{
+		Builder << TEXT("[...]");
+		return;
+	}
+	if constexpr (ReprPrivate::THasWriter<T>::value)
+	{
+		Builder << TEXT('[');
+		ReprPrivate::AppendWrittenElements(Builder, Array.GetData(), Array.Num(), Options);
+		Builder << TEXT(']');
+		return;
+	}
+	else if constexpr (TReprMaxLength<T>::Value != INDEX_NONE)
+	{
+		ReprPrivate::ReserveElements(Builder, Array.Num(), TReprMaxLength<T>::Value, Options);
+	}
+	const FReprOptions ElementOptions = Options.Descend();
+	Builder << TEXT('[');
+	for (int32 i = 0; i < Array.Num(); ++i)
+	{
+		if (i > 0)
+		{
+			Builder << TEXT(", ");
+		}
+		if (Options.IsExhausted(Builder, i))
+		{
+			Builder << TEXT("...");
+			break;
+		}
+		ReprTo(Builder, Array[i], ElementOptions);
+	}
+	Builder << TEXT(']');
+}
+
+template <typename T>
+void ReprTo(FStringBuilderBase& Builder, const TSet<T>& Set, const FReprOptions& Options = FReprOptions())
 {
-	return FString::Printf(TEXT("(%s, %s)"), *Repr(Pair.Key), *Repr(Pair.Value));
+	if (Options.MaxDepth <= 0)
+	{
+		Builder << TEXT("{...}");
+		return;
+	}
+	if constexpr (TReprMaxLength<T>::Value != INDEX_NONE)
+	{
+		ReprPrivate::ReserveElements(Builder, Set.Num(), TReprMaxLength<T>::Value, Options);
+	}
+	const FReprOptions ElementOptions = Options.Descend();
+	Builder << TEXT('{');
+	int32 Index = 0;
+	for (const T& Element : Set)
+	{
+		if (Index > 0)
+		{
+			Builder << TEXT(", ");
+		}
+		if (Options.IsExhausted(Builder, Index))
+		{
+			Builder << TEXT("...");
+			break;
+		}
+		ReprTo(Builder, Element, ElementOptions);
+		++Index;
+	}
+	Builder << TEXT('}');
+}
+
+template <typename K, typename V>
+void ReprTo(FStringBuilderBase& Builder, const TMap<K, V>& Map, const FReprOptions& Options = FReprOptions())
+{
+	if (Options.MaxDepth <= 0)
+	{
+		Builder << TEXT("{...}");
+		return;
+	}
+	if constexpr (TReprMaxLength<K>::Value != INDEX_NONE and TReprMaxLength<V>::Value != INDEX_NONE)
+	{
+		ReprPrivate::ReserveElements(Builder, Map.Num(), TReprMaxLength<K>::Value + TReprMaxLength<V>::Value + 2,
+		                             Options);
+	}
+	const FReprOptions ElementOptions = Options.Descend();
+	Builder << TEXT('{');
+	int32 Index = 0;
+	for (const auto& Pair : Map)
+	{
+		if (Index > 0)
+		{
+			Builder << TEXT(", ");
+		}
+		if (Options.IsExhausted(Builder, Index))
+		{
+			Builder << TEXT("...");
+			break;
+		}
+		ReprTo(Builder, Pair.Key, ElementOptions);
+		Builder << TEXT(": ");
+		ReprTo(Builder, Pair.Value, ElementOptions);
+		++Index;
+	}
+	Builder << TEXT('}');
+}
+
+template <typename T>
+void ReprTo(FStringBuilderBase& Builder, const TOptional<T>& Optional, const FReprOptions& Options = FReprOptions())
+{
+	if (Optional.IsSet())
+	{
+		Builder << TEXT("Some(");
+		ReprTo(Builder, Optional.GetValue(), Options);
+		Builder << TEXT(')');
+		return;
+	}
+	Builder << TEXT("None");
+}
+
+template <typename Tuple, size_t... Is>
+void ReprTupleTo(FStringBuilderBase& Builder, const Tuple& Tup, const FReprOptions& Options,
+                 std::index_sequence<Is...>)
+{
+	// The comma fold keeps the elements in declaration order.
+	((Builder << (Is == 0 ? TEXT("") : TEXT(", ")), ReprTo(Builder, Tup.template Get<Is>(), Options)), ...);
+}
+
+template <typename... Types>
+void ReprTo(FStringBuilderBase& Builder, const TTuple<Types...>& Tuple, const FReprOptions& Options = FReprOptions())
+{
+	Builder << TEXT('(');
+	ReprTupleTo(Builder, Tuple, Options, std::index_sequence_for<Types...>{});
+	Builder << TEXT(')');
 }
 
 template <>
 inline FString Repr(const int8& Value)
 {
-	return FString::Printf(TEXT("%i_i8"), Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
 inline FString Repr(const int16& Value)
 {
-	return FString::Printf(TEXT("%i_i16"), Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
 inline FString Repr(const int32& Value)
 {
-	return FString::Printf(TEXT("%i_i32"), Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
 inline FString Repr(const int64& Value)
 {
-	return FString::Printf(TEXT("%lld_i64"), Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
 inline FString Repr(const uint8& Value)
 {
-	return FString::Printf(TEXT("%u_u8"), Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
 inline FString Repr(const uint16& Value)
 {
-	return FString::Printf(TEXT("%u_u16"), Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
 inline FString Repr(const uint32& Value)
 {
-	return FString::Printf(TEXT("%u_u32"), Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
 inline FString Repr(const uint64& Value)
 {
-	return FString::Printf(TEXT("%llu_u64"), Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
 inline FString Repr(const float& Value)
 {
-	return FString::Printf(TEXT("%f_f32"), Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
 inline FString Repr(const double& Value)
 {
-	return FString::Printf(TEXT("%f_f64"), Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
@@ -82,7 +727,7 @@ inline FString Repr(const bool& Value)
 template <>
 inline FString Repr(const FString& Value)
 {
-	return FString::Printf(TEXT("\"%s\""), *Value);
+	return ReprViaBuilder(Value);
 }
 
 template <>
@@ -97,93 +742,94 @@ inline FString Repr(const FText& Value)
 	return Value.ToString();
 }
 
+template <typename T, typename U>
+FString Repr(const TPair<T, U>& Pair)
+{
+	return ReprViaBuilder(Pair);
+}
+
 template <typename T>
 FString Repr(const TArray<T>& Array)
 {
-	FString Result = TEXT("[");
-	for (int32 i = 0; i < Array.Num(); ++i)
-	{
-		Result += Repr(Array[i]);
-		if (i < Array.Num() - 1)
-		{
-			Result += TEXT(", ");
-		}
-	}
-	Result += TEXT("]");
-	return Result;
+	return ReprViaBuilder(Array);
 }
 
 template <typename T>
 FString Repr(const TSet<T>& Set)
 {
-	FString Result = TEXT("{");
-	int32 Index = 0;
-	for (const T& Element : Set)
-	{
-		Result += Repr(Element);
-		if (Index < Set.Num() - 1)
-		{
-			Result += TEXT(", ");
-		}
-		++Index;
-	}
-	Result += TEXT("}");
-	return Result;
+	return ReprViaBuilder(Set);
 }
 
 template <typename K, typename V>
 FString Repr(const TMap<K, V>& Map)
 {
-	FString Result = TEXT("{");
-	int32 Index = 0;
-	for (const auto& Pair : Map)
-	{
-		Result += FString::Printf(TEXT("%s: %s"), *Repr(Pair.Key), *Repr(Pair.Value));
-		if (Index < Map.Num() - 1)
-		{
-			Result += TEXT(", ");
-		}
-		++Index;
-	}
-	Result += TEXT("}");
-	return Result;
+	return ReprViaBuilder(Map);
 }
 
 template <typename T>
 FString Repr(const TOptional<T>& Optional)
 {
-	if (Optional.IsSet())
-	{
-		return FString::Printf(TEXT("Some(%s)"), *Repr(Optional.GetValue()));
-	}
-	return TEXT("None");
+	return ReprViaBuilder(Optional);
 }
 
 template <typename... Types>
-FString Repr(const TTuple<Types...>& Tuple);
+FString Repr(const TTuple<Types...>& Tuple)
+{
+	return ReprViaBuilder(Tuple);
+}
 
-template <typename Tuple, size_t... Is>
-FString ReprTupleImpl(const Tuple& Tup, std::index_sequence<Is...>)
+template <typename T>
+FString Repr(const T& Value)
 {
-	TArray<FString> Elements = {Repr(Tup.template Get<Is>())...};
-	FString Result;
-	for (int32 i = 0; i < Elements.Num(); ++i)
-	{
-		Result += Elements[i];
-		if (i < Elements.Num() - 1)
-		{
-			Result += TEXT(", ");
-		}
-	}
-	return Result;
+	static_assert(THasReprFormatter<T>::value or TIsReprReflected<T>::value or TIsReprObjectPointer<T>::value,
+		"Repr has no formatter for this type: specialize TReprFormatter or make it a USTRUCT");
+	return ReprViaBuilder(Value);
 }
 
-template <typename... Types>
-FString Repr(const TTuple<Types...>& Tuple)
+/** Formats any supported value with the given limits. */
+template <typename T>
+FString Repr(const T& Value, const FReprOptions& Options)
 {
-	return TEXT("(") + ReprTupleImpl(Tuple, std::index_sequence_for<Types...>{}) + TEXT(")");
+	return ReprViaBuilder(Value, Options);
 }
 
-#define UE_REPR(x) UE_LOG(LogTemp, Display, TEXT("%s = %s"), TEXT(#x), *Repr(x))
-#define UE_REPR_WARNING(x) UE_LOG(LogTemp, Warning, TEXT("%s = %s"), TEXT(#x), *Repr(x))
-#define UE_REPR_ERROR(x) UE_LOG(LogTemp, Error, TEXT("%s = %s"), TEXT(#x), *Repr(x))
+#if NO_LOGGING
+#define UE_REPR_LOG(CategoryName, Verbosity, x) do { (void)sizeof(x); } while (false)
+#define UE_REPR_LOG_BOUNDED(CategoryName, Verbosity, x, Options) do { (void)sizeof(x); } while (false)
+#else
+/**
+ * Logs "x = Repr(x)" to the given category. Repr(x) is only evaluated when the category would print at that
+ * verbosity, and the whole statement is discarded at compile time below the category's compile-time verbosity
+ * or COMPILED_IN_MINIMUM_VERBOSITY.
+ */
+#define UE_REPR_LOG(CategoryName, Verbosity, x) \
+	do \
+	{ \
+		if constexpr (((ELogVerbosity::Verbosity & ELogVerbosity::VerbosityMask) <= ELogVerbosity::COMPILED_IN_MINIMUM_VERBOSITY) \
+			and ((ELogVerbosity::Verbosity & ELogVerbosity::VerbosityMask) <= FLogCategory##CategoryName::CompileTimeVerbosity)) \
+		{ \
+			if (!CategoryName.IsSuppressed(ELogVerbosity::Verbosity)) \
+			{ \
+				UE_LOG(CategoryName, Verbosity, TEXT("%s = %s"), TEXT(#x), *Repr(x)); \
+			} \
+		} \
+	} while (false)
+
+/** UE_REPR_LOG with FReprOptions limits, for values that may hold huge containers. */
+#define UE_REPR_LOG_BOUNDED(CategoryName, Verbosity, x, Options) \
+	do \
+	{ \
+		if constexpr (((ELogVerbosity::Verbosity & ELogVerbosity::VerbosityMask) <= ELogVerbosity::COMPILED_IN_MINIMUM_VERBOSITY) \
+			and ((ELogVerbosity::Verbosity & ELogVerbosity::VerbosityMask) <= FLogCategory##CategoryName::CompileTimeVerbosity)) \
+		{ \
+			if (!CategoryName.IsSuppressed(ELogVerbosity::Verbosity)) \
+			{ \
+				UE_LOG(CategoryName, Verbosity, TEXT("%s = %s"), TEXT(#x), *Repr(x, Options)); \
+			} \
+		} \
+	} while (false)
+#endif
+
+#define UE_REPR(x) UE_REPR_LOG(LogTemp, Display, x)
+#define UE_REPR_WARNING(x) UE_REPR_LOG(LogTemp, Warning, x)
+#define UE_REPR_ERROR(x) UE_REPR_LOG(LogTemp, Error, x)
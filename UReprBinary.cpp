@@ -0,0 +1,253 @@
+﻿#include "UReprBinary.h"
+
+namespace
+{
+	constexpr int32 MaxDecodeDepth = 256;
+
+	template <typename T>
+	bool ReadRaw(TArrayView<const uint8> Bytes, int32& Offset, T& Result)
+	{
+		if (Bytes.Num() - Offset < static_cast<int32>(sizeof(T)))
+		{
+			return false;
+		}
+		FMemory::Memcpy(&Result, Bytes.GetData() + Offset, sizeof(T));
+		Offset += sizeof(T);
+		return true;
+	}
+
+	/** Narrows a decoded integer to the encoded type and formats it with the matching ReprTo specialization. */
+	template <typename T, typename U>
+	bool ReprIntegerTo(FStringBuilderBase& Builder, U Value)
+	{
+		if (Value < static_cast<U>(TNumericLimits<T>::Min()) or Value > static_cast<U>(TNumericLimits<T>::Max()))
+		{
+			return false;
+		}
+		ReprTo(Builder, static_cast<T>(Value));
+		return true;
+	}
+}
+
+bool FReprBinaryDecoder::Decode(TArrayView<const uint8> Bytes, FString& Result)
+{
+	TStringBuilder<1024> Builder;
+	int32 Offset = 0;
+	bool bSucceeded = true;
+	while (Offset < Bytes.Num())
+	{
+		if (Builder.Len() > 0)
+		{
+			Builder << TEXT('\n');
+		}
+		if (!DecodeValueTo(Builder, Bytes, Offset))
+		{
+			bSucceeded = false;
+			break;
+		}
+	}
+	Result = FString(Builder.Len(), Builder.GetData());
+	return bSucceeded;
+}
+
+bool FReprBinaryDecoder::DecodeValueTo(FStringBuilderBase& Builder, TArrayView<const uint8> Bytes, int32& Offset)
+{
+	return DecodeValueTo(Builder, Bytes, Offset, 0);
+}
+
+bool FReprBinaryDecoder::DecodeValueTo(FStringBuilderBase& Builder, TArrayView<const uint8> Bytes, int32& Offset,
+                                       int32 Depth)
+{
+	if (Offset >= Bytes.Num() or Depth > MaxDecodeDepth)
+	{
+		return false;
+	}
+	const auto Tag = static_cast<EReprBinaryTag>(Bytes[Offset++]);
+	uint64 Unsigned = 0;
+	int64 Signed = 0;
+	uint64 Count = 0;
+	FString String;
+	switch (Tag)
+	{
+	case EReprBinaryTag::Int8:
+		return ReadSignedVarint(Bytes, Offset, Signed) and ReprIntegerTo<int8>(Builder, Signed);
+	case EReprBinaryTag::Int16:
+		return ReadSignedVarint(Bytes, Offset, Signed) and ReprIntegerTo<int16>(Builder, Signed);
+	case EReprBinaryTag::Int32:
+		return ReadSignedVarint(Bytes, Offset, Signed) and ReprIntegerTo<int32>(Builder, Signed);
+	case EReprBinaryTag::Int64:
+		return ReadSignedVarint(Bytes, Offset, Signed) and ReprIntegerTo<int64>(Builder, Signed);
+	case EReprBinaryTag::UInt8:
+		return ReadVarint(Bytes, Offset, Unsigned) and ReprIntegerTo<uint8>(Builder, Unsigned);
+	case EReprBinaryTag::UInt16:
+		return ReadVarint(Bytes, Offset, Unsigned) and ReprIntegerTo<uint16>(Builder, Unsigned);
+	case EReprBinaryTag::UInt32:
+		return ReadVarint(Bytes, Offset, Unsigned) and ReprIntegerTo<uint32>(Builder, Unsigned);
+	case EReprBinaryTag::UInt64:
+		return ReadVarint(Bytes, Offset, Unsigned) and ReprIntegerTo<uint64>(Builder, Unsigned);
+	case EReprBinaryTag::Float:
+		{
+			float Value = 0.0f;
+			if (!ReadRaw(Bytes, Offset, Value))
+			{
+				return false;
+			}
+			ReprTo(Builder, Value);
+			return true;
+		}
+	case EReprBinaryTag::Double:
+		{
+			double Value = 0.0;
+			if (!ReadRaw(Bytes, Offset, Value))
+			{
+				return false;
+			}
+			ReprTo(Builder, Value);
+			return true;
+		}
+	case EReprBinaryTag::False:
+		ReprTo(Builder, false);
+		return true;
+	case EReprBinaryTag::True:
+		ReprTo(Builder, true);
+		return true;
+	case EReprBinaryTag::String:
+		if (!ReadString(Bytes, Offset, String))
+		{
+			return false;
+		}
+		ReprTo(Builder, String);
+		return true;
+	case EReprBinaryTag::Name:
+	case EReprBinaryTag::Text:
+	case EReprBinaryTag::ReprText:
+		// Names and texts are printed unquoted, and pre-rendered text is already in its final form.
+		if (!ReadString(Bytes, Offset, String))
+		{
+			return false;
+		}
+		Builder << String;
+		return true;
+	case EReprBinaryTag::Pair:
+		Builder << TEXT('(');
+		if (!DecodeValueTo(Builder, Bytes, Offset, Depth + 1))
+		{
+			return false;
+		}
+		Builder << TEXT(", ");
+		if (!DecodeValueTo(Builder, Bytes, Offset, Depth + 1))
+		{
+			return false;
+		}
+		Builder << TEXT(')');
+		return true;
+	case EReprBinaryTag::Array:
+	case EReprBinaryTag::Set:
+	case EReprBinaryTag::Tuple:
+		{
+			if (!ReadVarint(Bytes, Offset, Count))
+			{
+				return false;
+			}
+			const TCHAR* const Brackets = Tag == EReprBinaryTag::Array
+				                              ? TEXT("[]")
+				                              : Tag == EReprBinaryTag::Set
+				                              ? TEXT("{}")
+				                              : TEXT("()");
+			Builder << Brackets[0];
+			for (uint64 i = 0; i < Count; ++i)
+			{
+				if (i > 0)
+				{
+					Builder << TEXT(", ");
+				}
+				if (!DecodeValueTo(Builder, Bytes, Offset, Depth + 1))
+				{
+					return false;
+				}
+			}
+			Builder << Brackets[1];
+			return true;
+		}
+	case EReprBinaryTag::Map:
+		if (!ReadVarint(Bytes, Offset, Count))
+		{
+			return false;
+		}
+		Builder << TEXT('{');
+		for (uint64 i = 0; i < Count; ++i)
+		{
+			if (i > 0)
+			{
+				Builder << TEXT(", ");
+			}
+			if (!DecodeValueTo(Builder, Bytes, Offset, Depth + 1))
+			{
+				return false;
+			}
+			Builder << TEXT(": ");
+			if (!DecodeValueTo(Builder, Bytes, Offset, Depth + 1))
+			{
+				return false;
+			}
+		}
+		Builder << TEXT('}');
+		return true;
+	case EReprBinaryTag::None:
+		Builder << TEXT("None");
+		return true;
+	case EReprBinaryTag::Some:
+		Builder << TEXT("Some(");
+		if (!DecodeValueTo(Builder, Bytes, Offset, Depth + 1))
+		{
+			return false;
+		}
+		Builder << TEXT(')');
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool FReprBinaryDecoder::ReadVarint(TArrayView<const uint8> Bytes, int32& Offset, uint64& Result)
+{
+	Result = 0;
+	for (int32 Shift = 0; Shift < 64; Shift += 7)
+	{
+		if (Offset >= Bytes.Num())
+		{
+			return false;
+		}
+		const uint8 Byte = Bytes[Offset++];
+		Result |= static_cast<uint64>(Byte & 0x7f) << Shift;
+		if ((Byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FReprBinaryDecoder::ReadSignedVarint(TArrayView<const uint8> Bytes, int32& Offset, int64& Result)
+{
+	uint64 ZigZag = 0;
+	if (!ReadVarint(Bytes, Offset, ZigZag))
+	{
+		return false;
+	}
+	Result = static_cast<int64>(ZigZag >> 1) ^ -static_cast<int64>(ZigZag & 1);
+	return true;
+}
+
+bool FReprBinaryDecoder::ReadString(TArrayView<const uint8> Bytes, int32& Offset, FString& Result)
+{
+	uint64 Length = 0;
+	if (!ReadVarint(Bytes, Offset, Length) or Length > static_cast<uint64>(Bytes.Num() - Offset))
+	{
+		return false;
+	}
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Bytes.GetData() + Offset), static_cast<int32>(Length));
+	Result = FString(Converted.Length(), Converted.Get());
+	Offset += static_cast<int32>(Length);
+	return true;
+}
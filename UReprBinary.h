@@ -0,0 +1,271 @@
+#pragma once
+#include "URepr.h"
+
+/**
+ * Binary sibling of Repr for high-volume state capture. ReprBinaryTo appends a compact tagged encoding of a value
+ * to a byte buffer: varint integers, raw float bits and length-prefixed UTF-8 strings and containers.
+ * FReprBinaryDecoder renders a buffer back into exactly the text Repr would have produced.
+ * Types without a ReprBinaryTo overload are stored as their Repr text.
+ */
+enum class EReprBinaryTag : uint8
+{
+	Int8,
+	Int16,
+	Int32,
+	Int64,
+	UInt8,
+	UInt16,
+	UInt32,
+	UInt64,
+	Float,
+	Double,
+	False,
+	True,
+	String,
+	Name,
+	Text,
+	Pair,
+	Array,
+	Set,
+	Map,
+	None,
+	Some,
+	Tuple,
+	/** Pre-rendered Repr text of a type with no binary encoding */
+	ReprText
+};
+
+namespace ReprBinaryPrivate
+{
+	inline void WriteTag(TArray<uint8>& Bytes, EReprBinaryTag Tag)
+	{
+		Bytes.Add(static_cast<uint8>(Tag));
+	}
+
+	inline void WriteVarint(TArray<uint8>& Bytes, uint64 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Bytes.Add(static_cast<uint8>(Value | 0x80));
+			Value >>= 7;
+		}
+		Bytes.Add(static_cast<uint8>(Value));
+	}
+
+	/** Zigzag keeps small negative numbers short: 0, -1, 1, -2 map to 0, 1, 2, 3. */
+	inline void WriteSignedVarint(TArray<uint8>& Bytes, int64 Value)
+	{
+		WriteVarint(Bytes, (static_cast<uint64>(Value) << 1) ^ static_cast<uint64>(Value >> 63));
+	}
+
+	template <typename T>
+	void WriteRaw(TArray<uint8>& Bytes, const T& Value)
+	{
+		static_assert(PLATFORM_LITTLE_ENDIAN, "The binary Repr encoding stores raw little-endian values");
+		Bytes.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+	}
+
+	inline void WriteString(TArray<uint8>& Bytes, EReprBinaryTag Tag, FStringView Value)
+	{
+		WriteTag(Bytes, Tag);
+		const FTCHARToUTF8 Utf8(Value.GetData(), Value.Len());
+		WriteVarint(Bytes, Utf8.Length());
+		Bytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+}
+
+template <typename T>
+void ReprBinaryTo(TArray<uint8>& Bytes, const T& Value)
+{
+	ReprBinaryPrivate::WriteString(Bytes, EReprBinaryTag::ReprText, Repr(Value));
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const int8& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Int8);
+	ReprBinaryPrivate::WriteSignedVarint(Bytes, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const int16& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Int16);
+	ReprBinaryPrivate::WriteSignedVarint(Bytes, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const int32& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Int32);
+	ReprBinaryPrivate::WriteSignedVarint(Bytes, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const int64& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Int64);
+	ReprBinaryPrivate::WriteSignedVarint(Bytes, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const uint8& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::UInt8);
+	ReprBinaryPrivate::WriteVarint(Bytes, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const uint16& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::UInt16);
+	ReprBinaryPrivate::WriteVarint(Bytes, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const uint32& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::UInt32);
+	ReprBinaryPrivate::WriteVarint(Bytes, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const uint64& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::UInt64);
+	ReprBinaryPrivate::WriteVarint(Bytes, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const float& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Float);
+	ReprBinaryPrivate::WriteRaw(Bytes, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const double& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Double);
+	ReprBinaryPrivate::WriteRaw(Bytes, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const bool& Value)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, Value ? EReprBinaryTag::True : EReprBinaryTag::False);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const FString& Value)
+{
+	ReprBinaryPrivate::WriteString(Bytes, EReprBinaryTag::String, Value);
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const FName& Value)
+{
+	TStringBuilder<FName::StringBufferSize> Name;
+	Value.AppendString(Name);
+	ReprBinaryPrivate::WriteString(Bytes, EReprBinaryTag::Name, Name.ToView());
+}
+
+template <>
+inline void ReprBinaryTo(TArray<uint8>& Bytes, const FText& Value)
+{
+	ReprBinaryPrivate::WriteString(Bytes, EReprBinaryTag::Text, Value.ToString());
+}
+
+template <typename T, typename U>
+void ReprBinaryTo(TArray<uint8>& Bytes, const TPair<T, U>& Pair)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Pair);
+	ReprBinaryTo(Bytes, Pair.Key);
+	ReprBinaryTo(Bytes, Pair.Value);
+}
+
+template <typename T>
+void ReprBinaryTo(TArray<uint8>& Bytes, const TArray<T>& Array)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Array);
+	ReprBinaryPrivate::WriteVarint(Bytes, Array.Num());
+	for (const T& Element : Array)
+	{
+		ReprBinaryTo(Bytes, Element);
+	}
+}
+
+template <typename T>
+void ReprBinaryTo(TArray<uint8>& Bytes, const TSet<T>& Set)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Set);
+	ReprBinaryPrivate::WriteVarint(Bytes, Set.Num());
+	for (const T& Element : Set)
+	{
+		ReprBinaryTo(Bytes, Element);
+	}
+}
+
+template <typename K, typename V>
+void ReprBinaryTo(TArray<uint8>& Bytes, const TMap<K, V>& Map)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Map);
+	ReprBinaryPrivate::WriteVarint(Bytes, Map.Num());
+	for (const auto& Pair : Map)
+	{
+		ReprBinaryTo(Bytes, Pair.Key);
+		ReprBinaryTo(Bytes, Pair.Value);
+	}
+}
+
+template <typename T>
+void ReprBinaryTo(TArray<uint8>& Bytes, const TOptional<T>& Optional)
+{
+	if (!Optional.IsSet())
+	{
+		ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::None);
+		return;
+	}
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Some);
+	ReprBinaryTo(Bytes, Optional.GetValue());
+}
+
+template <typename... Types>
+void ReprBinaryTo(TArray<uint8>& Bytes, const TTuple<Types...>& Tuple)
+{
+	ReprBinaryPrivate::WriteTag(Bytes, EReprBinaryTag::Tuple);
+	ReprBinaryPrivate::WriteVarint(Bytes, sizeof...(Types));
+	VisitTupleElements([&Bytes](const auto& Element)
+	{
+		ReprBinaryTo(Bytes, Element);
+	}, Tuple);
+}
+
+/** @return The binary encoding of a single value */
+template <typename T>
+TArray<uint8> ReprBinary(const T& Value)
+{
+	TArray<uint8> Bytes;
+	ReprBinaryTo(Bytes, Value);
+	return Bytes;
+}
+
+/**
+ * Renders buffers written by ReprBinaryTo back into Repr text. A buffer may hold several values appended one
+ * after the other; they are rendered one per line.
+ */
+class DEBUGUTILS_API FReprBinaryDecoder
+{
+public:
+	/** @return Whether the whole buffer decoded; on failure Result holds the values decoded so far */
+	static bool Decode(TArrayView<const uint8> Bytes, FString& Result);
+	/** Appends the next value of the buffer to Builder and advances Offset past it. */
+	static bool DecodeValueTo(FStringBuilderBase& Builder, TArrayView<const uint8> Bytes, int32& Offset);
+
+private:
+	static bool ReadVarint(TArrayView<const uint8> Bytes, int32& Offset, uint64& Result);
+	static bool ReadSignedVarint(TArrayView<const uint8> Bytes, int32& Offset, int64& Result);
+	static bool ReadString(TArrayView<const uint8> Bytes, int32& Offset, FString& Result);
+	/** Containers nest through recursion, so untrusted input is cut off at this depth. */
+	static bool DecodeValueTo(FStringBuilderBase& Builder, TArrayView<const uint8> Bytes, int32& Offset, int32 Depth);
+};
@@ -0,0 +1,69 @@
+﻿#include "UReprBinary.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** Decoding the binary encoding of Value must give back exactly the text Repr writes for it. */
+	template <typename T>
+	void TestRoundTrip(FAutomationTestBase& Test, const TCHAR* What, const T& Value)
+	{
+		FString Decoded;
+		if (Test.TestTrue(*FString::Printf(TEXT("%s decodes"), What),
+		                  FReprBinaryDecoder::Decode(ReprBinary(Value), Decoded)))
+		{
+			Test.TestEqual(What, Decoded, Repr(Value));
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReprBinaryRoundTripTest, "DebugUtils.Repr.BinaryRoundTrip",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+                                 | EAutomationTestFlags::EngineFilter)
+
+bool FReprBinaryRoundTripTest::RunTest(const FString& Parameters)
+{
+	TestRoundTrip(*this, TEXT("int8 min"), MIN_int8);
+	TestRoundTrip(*this, TEXT("int16 min"), MIN_int16);
+	TestRoundTrip(*this, TEXT("int32 min"), MIN_int32);
+	TestRoundTrip(*this, TEXT("int32 negative"), -1);
+	TestRoundTrip(*this, TEXT("int64 min"), MIN_int64);
+	TestRoundTrip(*this, TEXT("int64 max"), MAX_int64);
+	TestRoundTrip(*this, TEXT("uint8 max"), MAX_uint8);
+	TestRoundTrip(*this, TEXT("uint64 max"), MAX_uint64);
+	TestRoundTrip(*this, TEXT("float 0.1"), 0.1f);
+	TestRoundTrip(*this, TEXT("float 1e30"), 1e30f);
+	TestRoundTrip(*this, TEXT("float negative zero"), -0.0f);
+	TestRoundTrip(*this, TEXT("double"), -1.0e-300);
+	TestRoundTrip(*this, TEXT("bool"), true);
+	TestRoundTrip(*this, TEXT("string"), FString(TEXT("Quote \" and Ünicode")));
+	TestRoundTrip(*this, TEXT("name"), FName(TEXT("Actor"), 3));
+	TestRoundTrip(*this, TEXT("text"), FText::FromString(TEXT("Text")));
+
+	TMap<FString, TArray<TOptional<int32>>> Nested;
+	Nested.Add(TEXT("Empty"));
+	Nested.Add(TEXT("Mixed"), {TOptional<int32>(MIN_int32), TOptional<int32>(), TOptional<int32>(MAX_int32)});
+	Nested.Add(TEXT("Negative"), {TOptional<int32>(-42)});
+	TestRoundTrip(*this, TEXT("nested map"), Nested);
+
+	const TTuple<int64, float, FString, TSet<int32>, TPair<bool, double>> Tuple(
+		-7, 1e30f, TEXT("Tuple"), TSet<int32>({1, -1}), TPair<bool, double>(false, 0.1));
+	TestRoundTrip(*this, TEXT("tuple"), Tuple);
+
+	// Types without a binary encoding are stored as their Repr text.
+	TestRoundTrip(*this, TEXT("Repr text fallback"), FVector(0.1, -2.0, 1e30));
+
+	// Values appended one after the other are rendered one per line.
+	TArray<uint8> Bytes;
+	ReprBinaryTo(Bytes, 1);
+	ReprBinaryTo(Bytes, FString(TEXT("Two")));
+	FString Decoded;
+	if (TestTrue(TEXT("Appended values decode"), FReprBinaryDecoder::Decode(Bytes, Decoded)))
+	{
+		TestEqual(TEXT("Appended values"), Decoded, Repr(1) + TEXT("\n") + Repr(FString(TEXT("Two"))));
+	}
+	return true;
+}
+
+#endif
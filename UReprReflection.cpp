@@ -0,0 +1,605 @@
+﻿#include "UReprReflection.h"
+#include "URepr.h"
+#include "Hash/CityHash.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/TextProperty.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	struct FReprValuePlan;
+
+	using FReprValueFormatter = void (*)(FStringBuilderBase&, const FReprValuePlan&, const void*, const FReprOptions&);
+	using FReprValueHasher = uint64 (*)(const FReprValuePlan&, const void*, uint64 Seed);
+
+	/**
+	 * How to format one value of a property: the formatter picked for its type, the hasher that sees the same state,
+	 * plus the plans of its elements.
+	 */
+	struct FReprValuePlan
+	{
+		const FProperty* Property = nullptr;
+		FReprValueFormatter Format = nullptr;
+		FReprValueHasher Hash = nullptr;
+		/** Size of one value, for the hashers that read raw bytes */
+		int32 ElementSize = 0;
+		/** The inner value of arrays and sets, the key and the value of maps */
+		TArray<FReprValuePlan> Elements;
+	};
+
+	struct FReprFieldPlan
+	{
+		/** "Name=", built once so formatting never touches the property name */
+		FString Label;
+		int32 Offset = 0;
+		int32 ArrayDim = 1;
+		int32 Stride = 0;
+		FReprValuePlan Value;
+	};
+
+	struct FReprStructPlan
+	{
+		FString TypeName;
+		TArray<FReprFieldPlan> Fields;
+	};
+
+	FRWLock PlansLock;
+
+	TMap<FObjectKey, TUniquePtr<FReprStructPlan>>& GetPlans()
+	{
+		static TMap<FObjectKey, TUniquePtr<FReprStructPlan>> Plans;
+		return Plans;
+	}
+
+	template <typename T>
+	void FormatScalar(FStringBuilderBase& Builder, const FReprValuePlan& Plan, const void* Data,
+	                  const FReprOptions& Options)
+	{
+		ReprTo(Builder, *static_cast<const T*>(Data), Options);
+	}
+
+	uint64 CombineHash(uint64 Seed, uint64 Hash)
+	{
+		return CityHash64WithSeed(reinterpret_cast<const char*>(&Hash), sizeof(Hash), Seed);
+	}
+
+	uint64 HashBytes(const FReprValuePlan& Plan, const void* Data, uint64 Seed)
+	{
+		return CityHash64WithSeed(static_cast<const char*>(Data), Plan.ElementSize, Seed);
+	}
+
+	uint64 HashString(const FString& Value, uint64 Seed)
+	{
+		return CityHash64WithSeed(reinterpret_cast<const char*>(*Value), Value.Len() * sizeof(TCHAR), Seed);
+	}
+
+	template <typename T>
+	uint64 HashStringScalar(const FReprValuePlan& Plan, const void* Data, uint64 Seed)
+	{
+		if constexpr (std::is_same_v<T, FText>)
+		{
+			return HashString(static_cast<const FText*>(Data)->ToString(), Seed);
+		}
+		else
+		{
+			return HashString(*static_cast<const FString*>(Data), Seed);
+		}
+	}
+
+	uint64 HashName(const FReprValuePlan& Plan, const void* Data, uint64 Seed)
+	{
+		return CombineHash(Seed, GetTypeHash(*static_cast<const FName*>(Data)));
+	}
+
+	uint64 HashBool(const FReprValuePlan& Plan, const void* Data, uint64 Seed)
+	{
+		return CombineHash(Seed, static_cast<const FBoolProperty*>(Plan.Property)->GetPropertyValue(Data) ? 1 : 0);
+	}
+
+	uint64 HashObjectReference(const FReprValuePlan& Plan, const void* Data, uint64 Seed)
+	{
+		const UObject* Object = static_cast<const FObjectPropertyBase*>(Plan.Property)->GetObjectPropertyValue(Data);
+		return CombineHash(Seed, reinterpret_cast<UPTRINT>(Object));
+	}
+
+	uint64 HashOpaque(const FReprValuePlan& Plan, const void* Data, uint64 Seed)
+	{
+		// Types printed as export text hash through the property when it supports that, otherwise by their bytes.
+		if (Plan.Property->HasAnyPropertyFlags(CPF_HasGetValueTypeHash))
+		{
+			return CombineHash(Seed, Plan.Property->GetValueTypeHash(Data));
+		}
+		return HashBytes(Plan, Data, Seed);
+	}
+
+	uint64 HashStructValue(const FReprValuePlan& Plan, const void* Data, uint64 Seed);
+
+	uint64 HashArray(const FReprValuePlan& Plan, const void* Data, uint64 Seed)
+	{
+		FScriptArrayHelper Helper(static_cast<const FArrayProperty*>(Plan.Property), Data);
+		const FReprValuePlan& ElementPlan = Plan.Elements[0];
+		uint64 Hash = CombineHash(Seed, Helper.Num());
+		for (int32 i = 0; i < Helper.Num(); ++i)
+		{
+			Hash = ElementPlan.Hash(ElementPlan, Helper.GetRawPtr(i), Hash);
+		}
+		return Hash;
+	}
+
+	uint64 HashSet(const FReprValuePlan& Plan, const void* Data, uint64 Seed)
+	{
+		FScriptSetHelper Helper(static_cast<const FSetProperty*>(Plan.Property), Data);
+		const FReprValuePlan& ElementPlan = Plan.Elements[0];
+		uint64 Hash = CombineHash(Seed, Helper.Num());
+		for (int32 Slot = 0, Index = 0; Index < Helper.Num(); ++Slot)
+		{
+			if (Helper.IsValidIndex(Slot))
+			{
+				Hash = ElementPlan.Hash(ElementPlan, Helper.GetElementPtr(Slot), Hash);
+				++Index;
+			}
+		}
+		return Hash;
+	}
+
+	uint64 HashMap(const FReprValuePlan& Plan, const void* Data, uint64 Seed)
+	{
+		FScriptMapHelper Helper(static_cast<const FMapProperty*>(Plan.Property), Data);
+		const FReprValuePlan& KeyPlan = Plan.Elements[0];
+		const FReprValuePlan& ValuePlan = Plan.Elements[1];
+		uint64 Hash = CombineHash(Seed, Helper.Num());
+		for (int32 Slot = 0, Index = 0; Index < Helper.Num(); ++Slot)
+		{
+			if (Helper.IsValidIndex(Slot))
+			{
+				Hash = KeyPlan.Hash(KeyPlan, Helper.GetKeyPtr(Slot), Hash);
+				Hash = ValuePlan.Hash(ValuePlan, Helper.GetValuePtr(Slot), Hash);
+				++Index;
+			}
+		}
+		return Hash;
+	}
+
+	void FormatBool(FStringBuilderBase& Builder, const FReprValuePlan& Plan, const void* Data,
+	                const FReprOptions& Options)
+	{
+		// Bitfield bools share their byte, so the property has to extract the bit.
+		ReprTo(Builder, static_cast<const FBoolProperty*>(Plan.Property)->GetPropertyValue(Data), Options);
+	}
+
+	void AppendEnumValue(FStringBuilderBase& Builder, const UEnum* Enum, int64 Value)
+	{
+		const FName Name = Enum->GetNameByValue(Value);
+		if (Name.IsNone())
+		{
+			ReprTo(Builder, Value);
+			return;
+		}
+		Name.AppendString(Builder);
+	}
+
+	void FormatByteEnum(FStringBuilderBase& Builder, const FReprValuePlan& Plan, const void* Data,
+	                    const FReprOptions& Options)
+	{
+		AppendEnumValue(Builder, static_cast<const FByteProperty*>(Plan.Property)->Enum,
+		                *static_cast<const uint8*>(Data));
+	}
+
+	void FormatEnum(FStringBuilderBase& Builder, const FReprValuePlan& Plan, const void* Data,
+	                const FReprOptions& Options)
+	{
+		const auto Property = static_cast<const FEnumProperty*>(Plan.Property);
+		AppendEnumValue(Builder, Property->GetEnum(),
+		                Property->GetUnderlyingProperty()->GetSignedIntPropertyValue(Data));
+	}
+
+	void FormatStruct(FStringBuilderBase& Builder, const FReprValuePlan& Plan, const void* Data,
+	                  const FReprOptions& Options)
+	{
+		FReprReflection::StructTo(Builder, static_cast<const FStructProperty*>(Plan.Property)->Struct, Data, Options);
+	}
+
+	void AppendObjectReference(FStringBuilderBase& Builder, const UObject* Object)
+	{
+		if (Object == nullptr)
+		{
+			Builder << TEXT("nullptr");
+			return;
+		}
+		// Referenced objects are printed by path rather than expanded, which keeps cycles and huge graphs out.
+		const UClass* Class = Object->GetClass();
+		Builder << Class->GetPrefixCPP() << Class->GetName() << TEXT('\'') << Object->GetPathName() << TEXT('\'');
+	}
+
+	void FormatObject(FStringBuilderBase& Builder, const FReprValuePlan& Plan, const void* Data,
+	                  const FReprOptions& Options)
+	{
+		AppendObjectReference(Builder, static_cast<const FObjectPropertyBase*>(Plan.Property)->GetObjectPropertyValue(Data));
+	}
+
+	void FormatExportedText(FStringBuilderBase& Builder, const FReprValuePlan& Plan, const void* Data,
+	                        const FReprOptions& Options)
+	{
+		FString Text;
+		Plan.Property->ExportText_Direct(Text, Data, Data, nullptr, PPF_None);
+		Options.AppendBounded(Builder, Text);
+	}
+
+	/** Shared by arrays and sets: the brackets, limits and separators of TArray and TSet ReprTo. */
+	template <typename FElementAt>
+	void FormatSequence(FStringBuilderBase& Builder, const FReprValuePlan& ElementPlan, int32 Num,
+	                    const TCHAR* Brackets, const FReprOptions& Options, FElementAt ElementAt)
+	{
+		if (Options.MaxDepth <= 0)
+		{
+			Builder << Brackets[0] << TEXT("...") << Brackets[1];
+			return;
+		}
+		const FReprOptions ElementOptions = Options.Descend();
+		Builder << Brackets[0];
+		for (int32 i = 0; i < Num; ++i)
+		{
+			if (i > 0)
+			{
+				Builder << TEXT(", ");
+			}
+			if (Options.IsExhausted(Builder, i))
+			{
+				Builder << TEXT("...");
+				break;
+			}
+			ElementPlan.Format(Builder, ElementPlan, ElementAt(i), ElementOptions);
+		}
+		Builder << Brackets[1];
+	}
+
+	void FormatArray(FStringBuilderBase& Builder, const FReprValuePlan& Plan, const void* Data,
+	                 const FReprOptions& Options)
+	{
+		FScriptArrayHelper Helper(static_cast<const FArrayProperty*>(Plan.Property), Data);
+		FormatSequence(Builder, Plan.Elements[0], Helper.Num(), TEXT("[]"), Options,
+		               [&Helper](int32 Index) { return Helper.GetRawPtr(Index); });
+	}
+
+	void FormatSet(FStringBuilderBase& Builder, const FReprValuePlan& Plan, const void* Data,
+	               const FReprOptions& Options)
+	{
+		FScriptSetHelper Helper(static_cast<const FSetProperty*>(Plan.Property), Data);
+		// Set storage is sparse, so walk the slots in order and skip the holes.
+		int32 Slot = -1;
+		FormatSequence(Builder, Plan.Elements[0], Helper.Num(), TEXT("{}"), Options, [&Helper, &Slot](int32 Index)
+		{
+			do
+			{
+				++Slot;
+			}
+			while (!Helper.IsValidIndex(Slot));
+			return Helper.GetElementPtr(Slot);
+		});
+	}
+
+	void FormatMap(FStringBuilderBase& Builder, const FReprValuePlan& Plan, const void* Data,
+	               const FReprOptions& Options)
+	{
+		if (Options.MaxDepth <= 0)
+		{
+			Builder << TEXT("{...}");
+			return;
+		}
+		FScriptMapHelper Helper(static_cast<const FMapProperty*>(Plan.Property), Data);
+		const FReprValuePlan& KeyPlan = Plan.Elements[0];
+		const FReprValuePlan& ValuePlan = Plan.Elements[1];
+		const FReprOptions ElementOptions = Options.Descend();
+		Builder << TEXT('{');
+		for (int32 Slot = 0, Index = 0; Index < Helper.Num(); ++Slot)
+		{
+			if (!Helper.IsValidIndex(Slot))
+			{
+				continue;
+			}
+			if (Index > 0)
+			{
+				Builder << TEXT(", ");
+			}
+			if (Options.IsExhausted(Builder, Index))
+			{
+				Builder << TEXT("...");
+				break;
+			}
+			KeyPlan.Format(Builder, KeyPlan, Helper.GetKeyPtr(Slot), ElementOptions);
+			Builder << TEXT(": ");
+			ValuePlan.Format(Builder, ValuePlan, Helper.GetValuePtr(Slot), ElementOptions);
+			++Index;
+		}
+		Builder << TEXT('}');
+	}
+
+	FReprValuePlan BuildValuePlan(const FProperty* Property)
+	{
+		FReprValuePlan Plan;
+		Plan.Property = Property;
+		Plan.ElementSize = Property->GetSize() / Property->ArrayDim;
+		// Numbers and enums print exactly what their bytes hold.
+		Plan.Hash = &HashBytes;
+		if (Property->IsA<FBoolProperty>())
+		{
+			Plan.Format = &FormatBool;
+			Plan.Hash = &HashBool;
+		}
+		else if (const FByteProperty* ByteProperty = CastField<FByteProperty>(Property))
+		{
+			Plan.Format = ByteProperty->Enum != nullptr ? &FormatByteEnum : &FormatScalar<uint8>;
+		}
+		else if (Property->IsA<FInt8Property>())
+		{
+			Plan.Format = &FormatScalar<int8>;
+		}
+		else if (Property->IsA<FInt16Property>())
+		{
+			Plan.Format = &FormatScalar<int16>;
+		}
+		else if (Property->IsA<FIntProperty>())
+		{
+			Plan.Format = &FormatScalar<int32>;
+		}
+		else if (Property->IsA<FInt64Property>())
+		{
+			Plan.Format = &FormatScalar<int64>;
+		}
+		else if (Property->IsA<FUInt16Property>())
+		{
+			Plan.Format = &FormatScalar<uint16>;
+		}
+		else if (Property->IsA<FUInt32Property>())
+		{
+			Plan.Format = &FormatScalar<uint32>;
+		}
+		else if (Property->IsA<FUInt64Property>())
+		{
+			Plan.Format = &FormatScalar<uint64>;
+		}
+		else if (Property->IsA<FFloatProperty>())
+		{
+			Plan.Format = &FormatScalar<float>;
+		}
+		else if (Property->IsA<FDoubleProperty>())
+		{
+			Plan.Format = &FormatScalar<double>;
+		}
+		else if (Property->IsA<FStrProperty>())
+		{
+			Plan.Format = &FormatScalar<FString>;
+			Plan.Hash = &HashStringScalar<FString>;
+		}
+		else if (Property->IsA<FNameProperty>())
+		{
+			Plan.Format = &FormatScalar<FName>;
+			Plan.Hash = &HashName;
+		}
+		else if (Property->IsA<FTextProperty>())
+		{
+			Plan.Format = &FormatScalar<FText>;
+			Plan.Hash = &HashStringScalar<FText>;
+		}
+		else if (Property->IsA<FEnumProperty>())
+		{
+			Plan.Format = &FormatEnum;
+		}
+		else if (Property->IsA<FStructProperty>())
+		{
+			Plan.Format = &FormatStruct;
+			Plan.Hash = &HashStructValue;
+		}
+		else if (Property->IsA<FSoftObjectProperty>())
+		{
+			// Soft references print their path through export text instead of resolving the object.
+			Plan.Format = &FormatExportedText;
+			Plan.Hash = &HashOpaque;
+		}
+		else if (Property->IsA<FObjectPropertyBase>())
+		{
+			Plan.Format = &FormatObject;
+			Plan.Hash = &HashObjectReference;
+		}
+		else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			Plan.Format = &FormatArray;
+			Plan.Hash = &HashArray;
+			Plan.Elements.Add(BuildValuePlan(ArrayProperty->Inner));
+		}
+		else if (const FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+		{
+			Plan.Format = &FormatSet;
+			Plan.Hash = &HashSet;
+			Plan.Elements.Add(BuildValuePlan(SetProperty->ElementProp));
+		}
+		else if (const FMapProperty* MapProperty = CastField<FMapProperty>(Property))
+		{
+			Plan.Format = &FormatMap;
+			Plan.Hash = &HashMap;
+			Plan.Elements.Add(BuildValuePlan(MapProperty->KeyProp));
+			Plan.Elements.Add(BuildValuePlan(MapProperty->ValueProp));
+		}
+		else
+		{
+			Plan.Format = &FormatExportedText;
+			Plan.Hash = &HashOpaque;
+		}
+		return Plan;
+	}
+
+	TUniquePtr<FReprStructPlan> BuildStructPlan(const UStruct* Struct)
+	{
+		auto Plan = MakeUnique<FReprStructPlan>();
+		Plan->TypeName = FString(Struct->GetPrefixCPP()) + Struct->GetName();
+		// Base fields come first, the way they are declared.
+		TArray<const UStruct*, TInlineAllocator<8>> Chain;
+		for (const UStruct* Current = Struct; Current != nullptr; Current = Current->GetSuperStruct())
+		{
+			Chain.Insert(Current, 0);
+		}
+		for (const UStruct* Current : Chain)
+		{
+			for (TFieldIterator<FProperty> It(Current, EFieldIteratorFlags::ExcludeSuper); It; ++It)
+			{
+				const FProperty* Property = *It;
+				if (Property->HasAnyPropertyFlags(CPF_Deprecated))
+				{
+					continue;
+				}
+				FReprFieldPlan& Field = Plan->Fields.AddDefaulted_GetRef();
+				Field.Label = Property->GetName() + TEXT("=");
+				Field.Offset = Property->GetOffset_ForInternal();
+				Field.ArrayDim = Property->ArrayDim;
+				Field.Stride = Property->GetSize() / Property->ArrayDim;
+				Field.Value = BuildValuePlan(Property);
+			}
+		}
+		return Plan;
+	}
+
+	const FReprStructPlan& FindOrBuildPlan(const UStruct* Struct)
+	{
+		const FObjectKey Key(Struct);
+		{
+			FReadScopeLock Lock(PlansLock);
+			if (const TUniquePtr<FReprStructPlan>* Plan = GetPlans().Find(Key))
+			{
+				return **Plan;
+			}
+		}
+		// Built outside the lock: nested struct plans are looked up lazily while formatting, not while building.
+		TUniquePtr<FReprStructPlan> NewPlan = BuildStructPlan(Struct);
+		FWriteScopeLock Lock(PlansLock);
+		TUniquePtr<FReprStructPlan>& Plan = GetPlans().FindOrAdd(Key);
+		if (!Plan.IsValid())
+		{
+			Plan = MoveTemp(NewPlan);
+		}
+		return *Plan;
+	}
+
+	void AppendFields(FStringBuilderBase& Builder, const FReprStructPlan& Plan, const uint8* Data,
+	                  const FReprOptions& Options, int32 FirstIndex)
+	{
+		const FReprOptions FieldOptions = Options.Descend();
+		for (int32 i = 0; i < Plan.Fields.Num(); ++i)
+		{
+			const int32 Index = FirstIndex + i;
+			if (Index > 0)
+			{
+				Builder << TEXT(", ");
+			}
+			if (Options.IsExhausted(Builder, Index))
+			{
+				Builder << TEXT("...");
+				return;
+			}
+			const FReprFieldPlan& Field = Plan.Fields[i];
+			Builder << Field.Label;
+			const uint8* Value = Data + Field.Offset;
+			if (Field.ArrayDim == 1)
+			{
+				Field.Value.Format(Builder, Field.Value, Value, FieldOptions);
+				continue;
+			}
+			Builder << TEXT('[');
+			for (int32 Element = 0; Element < Field.ArrayDim; ++Element)
+			{
+				if (Element > 0)
+				{
+					Builder << TEXT(", ");
+				}
+				Field.Value.Format(Builder, Field.Value, Value + Element * Field.Stride, FieldOptions);
+			}
+			Builder << TEXT(']');
+		}
+	}
+
+	uint64 HashFields(const FReprStructPlan& Plan, const uint8* Data, uint64 Seed)
+	{
+		uint64 Hash = Seed;
+		for (const FReprFieldPlan& Field : Plan.Fields)
+		{
+			for (int32 Element = 0; Element < Field.ArrayDim; ++Element)
+			{
+				Hash = Field.Value.Hash(Field.Value, Data + Field.Offset + Element * Field.Stride, Hash);
+			}
+		}
+		return Hash;
+	}
+
+	uint64 HashStructValue(const FReprValuePlan& Plan, const void* Data, uint64 Seed)
+	{
+		const UStruct* Struct = static_cast<const FStructProperty*>(Plan.Property)->Struct;
+		return HashFields(FindOrBuildPlan(Struct), static_cast<const uint8*>(Data), Seed);
+	}
+}
+
+void FReprReflection::StructTo(FStringBuilderBase& Builder, const UStruct* Struct, const void* Data,
+                               const FReprOptions& Options)
+{
+	if (Struct == nullptr or Data == nullptr)
+	{
+		Builder << TEXT("nullptr");
+		return;
+	}
+	const FReprStructPlan& Plan = FindOrBuildPlan(Struct);
+	Builder << Plan.TypeName;
+	if (Options.MaxDepth <= 0)
+	{
+		Builder << TEXT("(...)");
+		return;
+	}
+	Builder << TEXT('(');
+	AppendFields(Builder, Plan, static_cast<const uint8*>(Data), Options, 0);
+	Builder << TEXT(')');
+}
+
+void FReprReflection::ObjectTo(FStringBuilderBase& Builder, const UObject* Object, const FReprOptions& Options)
+{
+	if (Object == nullptr)
+	{
+		Builder << TEXT("nullptr");
+		return;
+	}
+	const FReprStructPlan& Plan = FindOrBuildPlan(Object->GetClass());
+	Builder << Plan.TypeName;
+	if (Options.MaxDepth <= 0)
+	{
+		Builder << TEXT("(...)");
+		return;
+	}
+	Builder << TEXT("(Name=");
+	Object->GetFName().AppendString(Builder);
+	AppendFields(Builder, Plan, reinterpret_cast<const uint8*>(Object), Options, 1);
+	Builder << TEXT(')');
+}
+
+uint64 FReprReflection::HashStruct(const UStruct* Struct, const void* Data)
+{
+	if (Struct == nullptr or Data == nullptr)
+	{
+		return 0;
+	}
+	return HashFields(FindOrBuildPlan(Struct), static_cast<const uint8*>(Data), reinterpret_cast<UPTRINT>(Struct));
+}
+
+uint64 FReprReflection::HashObject(const UObject* Object)
+{
+	if (Object == nullptr)
+	{
+		return 0;
+	}
+	const UClass* Class = Object->GetClass();
+	const uint64 Seed = CombineHash(reinterpret_cast<UPTRINT>(Class), GetTypeHash(Object->GetFName()));
+	return HashFields(FindOrBuildPlan(Class), reinterpret_cast<const uint8*>(Object), Seed);
+}
+
+void FReprReflection::ResetPlans()
+{
+	FWriteScopeLock Lock(PlansLock);
+	GetPlans().Reset();
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Misc/StringBuilder.h"
+#include "UObject/Class.h"
+#include <type_traits>
+
+struct FReprOptions;
+
+/**
+ * Formats reflected data by walking its FProperty chain. The walk happens once per type: the first call builds a
+ * format plan (property offsets, precomputed "Name=" labels and one formatter function per property) that is
+ * cached and reused, so later calls do no property iteration or name lookups.
+ */
+class DEBUGUTILS_API FReprReflection
+{
+public:
+	/** Appends "FTypeName(Field=Value, ...)" for the struct instance at Data. */
+	static void StructTo(FStringBuilderBase& Builder, const UStruct* Struct, const void* Data, const FReprOptions& Options);
+	/** Appends "UClassName(Name=ObjectName, Field=Value, ...)", or "nullptr". Referenced objects print as paths. */
+	static void ObjectTo(FStringBuilderBase& Builder, const UObject* Object, const FReprOptions& Options);
+	/**
+	 * 64-bit hashes of everything StructTo and ObjectTo print, computed from the same cached plans without formatting:
+	 * raw bytes for numbers and enums, characters for strings, recursion into structs and containers. Referenced
+	 * objects hash by identity, like they print by path.
+	 */
+	static uint64 HashStruct(const UStruct* Struct, const void* Data);
+	static uint64 HashObject(const UObject* Object);
+	/** Drops every cached plan, e.g. after hot reload replaced struct layouts. Must not run while formatting. */
+	static void ResetPlans();
+};
+
+/**
+ * Whether Repr formats T through reflection. True for USTRUCTs with a StaticStruct() and for the engine structs
+ * registered below; specialize it for other types that have a TBaseStructure.
+ */
+template <typename T, typename = void>
+struct TIsReprReflected : std::false_type
+{
+};
+
+template <typename T>
+struct TIsReprReflected<T, std::void_t<decltype(T::StaticStruct())>> : std::true_type
+{
+};
+
+#define UE_REPR_REFLECTED_STRUCT(Type) \
+	template <> \
+	struct TIsReprReflected<Type> : std::true_type \
+	{ \
+	};
+
+UE_REPR_REFLECTED_STRUCT(FVector)
+UE_REPR_REFLECTED_STRUCT(FVector2D)
+UE_REPR_REFLECTED_STRUCT(FVector4)
+UE_REPR_REFLECTED_STRUCT(FRotator)
+UE_REPR_REFLECTED_STRUCT(FQuat)
+UE_REPR_REFLECTED_STRUCT(FTransform)
+UE_REPR_REFLECTED_STRUCT(FPlane)
+UE_REPR_REFLECTED_STRUCT(FMatrix)
+UE_REPR_REFLECTED_STRUCT(FBox)
+UE_REPR_REFLECTED_STRUCT(FBox2D)
+UE_REPR_REFLECTED_STRUCT(FIntPoint)
+UE_REPR_REFLECTED_STRUCT(FIntVector)
+UE_REPR_REFLECTED_STRUCT(FColor)
+UE_REPR_REFLECTED_STRUCT(FLinearColor)
+UE_REPR_REFLECTED_STRUCT(FGuid)
+
+/** Whether T is a pointer to a UObject, which Repr formats through its class. */
+template <typename T>
+struct TIsReprObjectPointer
+	: std::bool_constant<std::is_pointer_v<T> and std::is_base_of_v<UObject, std::remove_cv_t<std::remove_pointer_t<T>>>>
+{
+};
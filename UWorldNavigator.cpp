@@ -1,5 +1,11 @@
 ﻿#include "UWorldNavigator.h"
+#include "DebugUtilsStats.h"
 #include "FPathStructure.h"
+#include "FWorldPathIndex.h"
+#include "FWorldNavigationSnapshot.h"
+#include "FPersistedWorldPathIndex.h"
+#include "Async/ParallelFor.h"
+#include "UObject/UObjectIterator.h"
 
 UActorComponent* UWorldNavigator::FindActorComponentByPath(FString& Path)
 {
@@ -20,96 +26,223 @@ UActorComponent* UWorldNavigator::FindActorComponentByPath(FString& Path)
 		return nullptr;
 	}
 	auto ErrorMessage = FString();
-	FPathStructure Result;
-	if (!FPathStructure::TryParse(Path, ErrorMessage, Result))
+	FCompiledPathStructure Result;
+	if (!FCompiledPathStructure::TryCompile(Path, ErrorMessage, Result, FNAME_Find))
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s"), *ErrorMessage);
+		return nullptr;
 	}
-	const auto World = FindObject<UWorld>(ANY_PACKAGE, *Result.WorldName);
-	if (World == nullptr)
+	return FindActorComponentByPath(Result);
+}
+
+UActorComponent* UWorldNavigator::FindActorComponentByPath(const FCompiledPathStructure& Path)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_ResolvePath);
+	const auto MatchingActor = FindActorByPath(Path);
+	if (MatchingActor == nullptr)
 	{
 		return nullptr;
 	}
-	int32 sameNumberHit = 0;
-	const auto Levels = GetAllLevelsInWorld(World);
-	ULevel* MatchingLevel = nullptr;
-	for (auto Level : Levels)
+	if (Path.ComponentNames.Num() != Path.ComponentIndices.Num())
+	{
+		throw FString(TEXT("Component names and indices must be the same length"));
+	}
+	if (Path.ComponentNames.Num() != 1)
+	{
+		throw FString(TEXT("Only one component layer should be specified"));
+	}
+	return FindComponentByName(MatchingActor, Path.ComponentNames[0], Path.ComponentIndices[0]);
+}
+
+USceneComponent* UWorldNavigator::FindSceneComponentByPath(FString& Path)
+{
+	if (Path.IsEmpty())
+	{
+		return nullptr;
+	}
+	if (Path == TEXT("[invalid world]"))
+	{
+		return nullptr;
+	}
+	if (Path == TEXT("[invalid level]"))
+	{
+		return nullptr;
+	}
+	if (Path == TEXT("[invalid actor]"))
+	{
+		return nullptr;
+	}
+	auto ErrorMessage = FString();
+	FCompiledPathStructure Result;
+	if (!FCompiledPathStructure::TryCompile(Path, ErrorMessage, Result, FNAME_Find))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s"), *ErrorMessage);
+		return nullptr;
+	}
+	return FindSceneComponentByPath(Result);
+}
+
+USceneComponent* UWorldNavigator::FindSceneComponentByPath(const FCompiledPathStructure& Path)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_ResolvePath);
+	const auto MatchingActor = FindActorByPath(Path);
+	if (MatchingActor == nullptr)
+	{
+		return nullptr;
+	}
+	if (Path.ComponentNames.Num() != Path.ComponentIndices.Num())
+	{
+		throw FString(TEXT("Component names and indices must be the same length"));
+	}
+	if (Path.ComponentNames.Num() == 0)
+	{
+		throw FString(TEXT("At least one component layer should be specified"));
+	}
+	// The first segment is the top of the attach hierarchy; every later one is an attach child of the previous match.
+	USceneComponent* MatchingComponent = Cast<USceneComponent>(
+		FindComponentByName(MatchingActor, Path.ComponentNames[0], Path.ComponentIndices[0]));
+	if (MatchingComponent == nullptr or Path.ComponentNames.Num() == 1)
+	{
+		return MatchingComponent;
+	}
+	// Without a registered index, a scratch one builds each owner's component table once for every segment.
+	TOptional<FWorldPathIndex> ScratchIndex;
+	auto Index = FWorldPathIndex::Find(MatchingActor->GetWorld());
+	if (Index == nullptr)
+	{
+		Index = &ScratchIndex.Emplace(MatchingActor->GetWorld(), false);
+	}
+	for (int32 i = 1; i < Path.ComponentNames.Num() and MatchingComponent != nullptr; ++i)
 	{
-		if (Level->GetName() != *Result.LevelName)
+		MatchingComponent = FindAttachChildByName(*Index, MatchingComponent, Path.ComponentNames[i],
+		                                          Path.ComponentIndices[i]);
+	}
+	return MatchingComponent;
+}
+
+TArray<UActorComponent*> UWorldNavigator::FindActorComponentsByPaths(const TArray<FString>& Paths)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_ResolvePath);
+	TArray<UActorComponent*> Results;
+	Results.SetNumZeroed(Paths.Num());
+	TArray<FCompiledPathStructure> CompiledPaths;
+	CompiledPaths.SetNum(Paths.Num());
+	// Group the paths by world so each world is looked up once and shares one set of level and actor tables.
+	TMap<FName, TArray<int32>> PathsByWorld;
+	for (int32 i = 0; i < Paths.Num(); ++i)
+	{
+		auto ErrorMessage = FString();
+		if (!FCompiledPathStructure::TryCompile(Paths[i], ErrorMessage, CompiledPaths[i], FNAME_Find))
 		{
+			UE_LOG(LogTemp, Error, TEXT("%s"), *ErrorMessage);
 			continue;
 		}
-		if (sameNumberHit == Result.LevelIndex)
+		if (CompiledPaths[i].ComponentNames.Num() != 1)
 		{
-			MatchingLevel = Level;
-			break;
+			UE_LOG(LogTemp, Error, TEXT("Only one component layer should be specified: %s"), *Paths[i]);
+			continue;
 		}
-		sameNumberHit += 1;
-	}
-	if (MatchingLevel == nullptr)
-	{
-		return nullptr;
+		PathsByWorld.FindOrAdd(CompiledPaths[i].WorldName).Add(i);
 	}
-	sameNumberHit = 0;
-	const auto Actors = GetAllActorsInLevel(MatchingLevel);
-	AActor* MatchingActor = nullptr;
-	for (auto Actor : Actors)
+	for (const auto& Pair : PathsByWorld)
 	{
-		if (Actor->GetName() != *Result.ActorName)
+		const auto World = FindWorldByName(Pair.Key);
+		if (World == nullptr)
 		{
 			continue;
 		}
-		if (sameNumberHit == Result.ActorIndex)
+		TOptional<FWorldPathIndex> ScratchIndex;
+		auto Index = FWorldPathIndex::Find(World);
+		if (Index == nullptr)
 		{
-			MatchingActor = Actor;
-			break;
+			Index = &ScratchIndex.Emplace(World, false);
+		}
+		for (const int32 PathIndex : Pair.Value)
+		{
+			const auto& Result = CompiledPaths[PathIndex];
+			const auto MatchingLevel = Index->FindLevel(Result.LevelName, Result.LevelIndex);
+			const auto MatchingActor = Index->FindActor(MatchingLevel, Result.ActorName, Result.ActorIndex);
+			Results[PathIndex] = Index->FindComponent(MatchingActor, Result.ComponentNames[0],
+			                                          Result.ComponentIndices[0]);
 		}
-		sameNumberHit += 1;
 	}
-	if (MatchingActor == nullptr)
+	return Results;
+}
+
+TArray<AActor*> UWorldNavigator::FindActorsByPattern(const FString& Pattern)
+{
+	auto ErrorMessage = FString();
+	FPathPattern Result;
+	if (!FPathPattern::TryParse(Pattern, ErrorMessage, Result))
 	{
-		return nullptr;
+		UE_LOG(LogTemp, Error, TEXT("%s"), *ErrorMessage);
+		return TArray<AActor*>();
 	}
-	const auto Components = GetAllComponentsInActor(MatchingActor);
-	UActorComponent* MatchingComponent = nullptr;
-	if (Result.ComponentNames.Num() != Result.ComponentIndices.Num())
+	if (Result.Components.Num() > 0)
 	{
-		throw FString(TEXT("Component names and indices must be the same length"));
+		UE_LOG(LogTemp, Error, TEXT("Actor patterns must not name components: %s"), *Pattern);
+		return TArray<AActor*>();
 	}
-	if (Result.ComponentNames.Num() != 1)
+	return FindActorsByPattern(Result);
+}
+
+TArray<UActorComponent*> UWorldNavigator::FindComponentsByPattern(const FString& Pattern)
+{
+	auto ErrorMessage = FString();
+	FPathPattern Result;
+	if (!FPathPattern::TryParse(Pattern, ErrorMessage, Result))
 	{
-		throw FString(TEXT("Only one component layer should be specified"));
+		UE_LOG(LogTemp, Error, TEXT("%s"), *ErrorMessage);
+		return TArray<UActorComponent*>();
 	}
-	for (int32 i = 0; i < Result.ComponentNames.Num(); ++i)
+	if (Result.Components.Num() == 0)
 	{
-		sameNumberHit = 0;
-		const auto ComponentName = Result.ComponentNames[i];
-		for (auto Component : Components)
-		{
-			if (Component->GetName() != *ComponentName)
-			{
-				continue;
-			}
-			if (sameNumberHit == Result.ComponentIndices[i])
-			{
-				MatchingComponent = Component;
-				break;
-			}
-			++sameNumberHit;
-		}
-		if (sameNumberHit < Result.ComponentIndices[i])
+		UE_LOG(LogTemp, Error, TEXT("At least one component layer should be specified: %s"), *Pattern);
+		return TArray<UActorComponent*>();
+	}
+	return FindComponentsByPattern(Result);
+}
+
+TArray<AActor*> UWorldNavigator::FindActorsByPattern(const FPathPattern& Pattern)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_ResolvePath);
+	TArray<AActor*> Result;
+	for (const auto World : FindWorldsByPattern(Pattern.World))
+	{
+		TOptional<FWorldPathIndex> ScratchIndex;
+		auto Index = FWorldPathIndex::Find(World);
+		if (Index == nullptr)
 		{
-			return nullptr;
+			Index = &ScratchIndex.Emplace(World, false);
 		}
+		FindActorsByPattern(Pattern, *Index, Result);
 	}
-	if (MatchingComponent == nullptr)
+	return Result;
+}
+
+TArray<UActorComponent*> UWorldNavigator::FindComponentsByPattern(const FPathPattern& Pattern)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_ResolvePath);
+	TArray<UActorComponent*> Result;
+	for (const auto World : FindWorldsByPattern(Pattern.World))
 	{
-		return nullptr;
+		TOptional<FWorldPathIndex> ScratchIndex;
+		auto Index = FWorldPathIndex::Find(World);
+		if (Index == nullptr)
+		{
+			Index = &ScratchIndex.Emplace(World, false);
+		}
+		TArray<AActor*> Actors;
+		FindActorsByPattern(Pattern, *Index, Actors);
+		for (const auto Actor : Actors)
+		{
+			Index->FindComponents(Actor, Pattern.Components, Result);
+		}
 	}
-	return MatchingComponent;
+	return Result;
 }
 
-USceneComponent* UWorldNavigator::FindSceneComponentByPath(FString& Path)
+AActor* UWorldNavigator::FindUActorByPath(FString& Path)
 {
 	if (Path.IsEmpty())
 	{
@@ -123,159 +256,384 @@ USceneComponent* UWorldNavigator::FindSceneComponentByPath(FString& Path)
 	{
 		return nullptr;
 	}
-	if (Path == TEXT("[invalid actor]"))
-	{
-		return nullptr;
-	}
 	auto ErrorMessage = FString();
-	FPathStructure Result;
-	if (!FPathStructure::TryParse(Path, ErrorMessage, Result))
+	FCompiledPathStructure Result;
+	if (!FCompiledPathStructure::TryCompile(Path, ErrorMessage, Result, FNAME_Find))
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s"), *ErrorMessage);
+		return nullptr;
 	}
-	const auto World = FindObject<UWorld>(ANY_PACKAGE, *Result.WorldName);
+	return FindUActorByPath(Result);
+}
+
+AActor* UWorldNavigator::FindUActorByPath(const FCompiledPathStructure& Path)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_ResolvePath);
+	const auto World = FindWorldByName(Path.WorldName);
 	if (World == nullptr)
 	{
 		return nullptr;
 	}
-	int32 sameNumberHit = 0;
-	const auto Levels = GetAllLevelsInWorld(World);
-	ULevel* MatchingLevel = nullptr;
-	for (auto Level : Levels)
+	if (FWorldPathIndex::Find(World) != nullptr)
 	{
-		if (Level->GetName() != *Result.LevelName)
+		return FindActorByPath(Path);
+	}
+	const auto Level = FindObjectFast<ULevel>(World, Path.LevelName);
+	if (Level == nullptr)
+	{
+		return nullptr;
+	}
+	const auto Actor = FindObjectFast<AActor>(Level, Path.ActorName);
+	if (Actor == nullptr)
+	{
+		return nullptr;
+	}
+	return Actor;
+}
+
+TMap<UObject*, FString> UWorldNavigator::GetAllWorldPaths(ULevel* Level)
+{
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_GeneratePath);
+	TMap<UObject*, FString> Results;
+	if (Level == nullptr or Level->GetWorld() == nullptr)
+	{
+		return Results;
+	}
+	const auto LevelPrefix = FString::Printf(TEXT("%s@%s[%d]:/"), *Level->GetWorld()->GetName(), *Level->GetName(),
+	                                         GetIndexOfSameLevel(Level));
+	// Same-name actor indices depend on enumeration order, so they are assigned up front in one sequential pass.
+	TArray<TPair<AActor*, int32>> Actors;
+	Actors.Reserve(Level->Actors.Num());
+	TMap<FName, int32> NextActorIndices;
+	for (AActor* Actor : Level->Actors)
+	{
+		if (Actor != nullptr)
 		{
-			continue;
+			Actors.Emplace(Actor, NextActorIndices.FindOrAdd(Actor->GetFName())++);
 		}
-		if (sameNumberHit == Result.LevelIndex)
+	}
+	// The workers only read the actors and components while this thread waits, and each writes its own slot.
+	TArray<TArray<TPair<UObject*, FString>>> PathsPerActor;
+	PathsPerActor.SetNum(Actors.Num());
+	ParallelFor(Actors.Num(), [&](int32 i)
+	{
+		AppendActorWorldPaths(LevelPrefix, Actors[i].Key, Actors[i].Value, PathsPerActor[i]);
+	});
+	int32 NumPaths = 0;
+	for (const auto& ActorPaths : PathsPerActor)
+	{
+		NumPaths += ActorPaths.Num();
+	}
+	Results.Reserve(NumPaths);
+	for (auto& ActorPaths : PathsPerActor)
+	{
+		for (auto& Pair : ActorPaths)
 		{
-			MatchingLevel = Level;
-			break;
+			Results.Add(Pair.Key, MoveTemp(Pair.Value));
 		}
-		sameNumberHit += 1;
 	}
-	if (MatchingLevel == nullptr)
+	return Results;
+}
+
+void UWorldNavigator::AppendActorWorldPaths(const FString& LevelPrefix, AActor* Actor, int32 ActorIndex,
+                                            TArray<TPair<UObject*, FString>>& Result)
+{
+	const auto ActorPath = FString::Printf(TEXT("%s%s[%d]"), *LevelPrefix, *Actor->GetName(), ActorIndex);
+	const auto ComponentPrefix = ActorPath + TEXT("->");
+	const auto Components = GetAllComponentsInActor(Actor);
+	Result.Reserve(Components.Num() + 1);
+	Result.Emplace(Actor, ActorPath);
+
+	// "Name[Index]" of every component, and the attach hierarchy of every scene component resolved so far.
+	TMap<const UActorComponent*, FString> Segments;
+	TMap<FName, int32> NextComponentIndices;
+	for (auto Component : Components)
 	{
-		return nullptr;
+		Segments.Add(Component, FString::Printf(TEXT("%s[%d]"), *Component->GetName(),
+		                                        NextComponentIndices.FindOrAdd(Component->GetFName())++));
 	}
-	sameNumberHit = 0;
-	const auto Actors = GetAllActorsInLevel(MatchingLevel);
-	AActor* MatchingActor = nullptr;
-	for (auto Actor : Actors)
+	const auto GetSegment = [&Segments](const UActorComponent* Component)
 	{
-		if (Actor->GetName() != *Result.ActorName)
+		if (const FString* Segment = Segments.Find(Component))
+		{
+			return *Segment;
+		}
+		// Attach parents owned by another actor are indexed among that actor's components.
+		int32 SameNameIndex = 0;
+		const auto Owner = Component->GetOwner();
+		for (auto OtherComponent : Owner != nullptr ? GetAllComponentsInActor(Owner) : TArray<UActorComponent*>())
+		{
+			if (OtherComponent == Component)
+			{
+				break;
+			}
+			if (OtherComponent->GetFName() == Component->GetFName())
+			{
+				++SameNameIndex;
+			}
+		}
+		return Segments.Add(Component, FString::Printf(TEXT("%s[%d]"), *Component->GetName(), SameNameIndex));
+	};
+	TMap<const USceneComponent*, FString> Hierarchies;
+	TArray<const USceneComponent*, TInlineAllocator<16>> Chain;
+	for (auto Component : Components)
+	{
+		const auto SceneComponent = Cast<USceneComponent>(Component);
+		if (SceneComponent == nullptr)
 		{
+			Result.Emplace(Component, ComponentPrefix + Segments[Component]);
 			continue;
 		}
-		if (sameNumberHit == Result.ActorIndex)
+		// Walk up to the closest ancestor whose hierarchy is known, then extend it downwards.
+		Chain.Reset();
+		const FString* KnownHierarchy = nullptr;
+		for (auto Current = SceneComponent; Current != nullptr; Current = Current->GetAttachParent())
 		{
-			MatchingActor = Actor;
-			break;
+			KnownHierarchy = Hierarchies.Find(Current);
+			if (KnownHierarchy != nullptr)
+			{
+				break;
+			}
+			Chain.Add(Current);
 		}
-		sameNumberHit += 1;
+		auto Hierarchy = KnownHierarchy != nullptr ? *KnownHierarchy : FString();
+		for (int32 i = Chain.Num() - 1; i >= 0; --i)
+		{
+			if (!Hierarchy.IsEmpty())
+			{
+				Hierarchy += TEXT('/');
+			}
+			Hierarchy += GetSegment(Chain[i]);
+			Hierarchies.Add(Chain[i], Hierarchy);
+		}
+		Result.Emplace(Component, ComponentPrefix + Hierarchy);
 	}
-	if (MatchingActor == nullptr)
+}
+
+void UWorldNavigator::SetPathIndexEnabled(UWorld* World, bool bEnabled)
+{
+	if (World == nullptr)
+	{
+		return;
+	}
+	if (bEnabled)
+	{
+		FWorldPathIndex::Register(World);
+	}
+	else
+	{
+		FWorldPathIndex::Unregister(World);
+	}
+}
+
+bool UWorldNavigator::IsPathIndexEnabled(UWorld* World)
+{
+	return FWorldPathIndex::Find(World) != nullptr;
+}
+
+bool UWorldNavigator::SavePathIndex(UWorld* World, const FString& FilePath)
+{
+	return FPersistedWorldPathIndex::Save(World, FilePath);
+}
+
+bool UWorldNavigator::LoadPathIndex(UWorld* World, const FString& FilePath)
+{
+	if (World == nullptr)
+	{
+		return false;
+	}
+	TUniquePtr<FPersistedWorldPathIndex> Persisted = FPersistedWorldPathIndex::Load(FilePath);
+	if (!Persisted.IsValid())
+	{
+		return false;
+	}
+	const int32 NumBoundLevels = Persisted->Bind(World);
+	UE_LOG(LogTemp, Log, TEXT("Path index %s matched %d level(s) of %s"), *FilePath, NumBoundLevels, *World->GetName());
+	FWorldPathIndex::Register(World).AttachPersisted(MoveTemp(Persisted));
+	return NumBoundLevels > 0;
+}
+
+void UWorldNavigator::PublishNavigationSnapshot(UWorld* World)
+{
+	if (World == nullptr)
+	{
+		return;
+	}
+	FWorldNavigationSnapshot::Publish(World);
+}
+
+AActor* UWorldNavigator::FindActorByPath(const FCompiledPathStructure& Path)
+{
+	const auto World = FindWorldByName(Path.WorldName);
+	if (World == nullptr)
 	{
 		return nullptr;
 	}
-	const auto Components = GetAllComponentsInActor(MatchingActor);
-	USceneComponent* MatchingComponent = nullptr;
-	if (Result.ComponentNames.Num() != Result.ComponentIndices.Num())
+	const auto MatchingLevel = FindLevelByName(World, Path.LevelName, Path.LevelIndex);
+	if (MatchingLevel == nullptr)
 	{
-		throw FString(TEXT("Component names and indices must be the same length"));
+		return nullptr;
 	}
-	if (Result.ComponentNames.Num() == 0)
+	return FindActorByName(MatchingLevel, Path.ActorName, Path.ActorIndex);
+}
+
+UWorld* UWorldNavigator::FindWorldByName(FName WorldName)
+{
+	if (WorldName.IsNone())
 	{
-		throw FString(TEXT("At least one component layer should be specified"));
+		return nullptr;
 	}
-	for (int32 i = 0; i < Result.ComponentNames.Num(); ++i)
+	if (const auto Index = FWorldPathIndex::FindByWorldName(WorldName))
 	{
-		sameNumberHit = 0;
-		const auto ComponentName = Result.ComponentNames[i];
-		for (auto Component : Components)
+		if (const auto World = Index->GetWorld())
 		{
-			if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
-			{
-				if (SceneComponent->GetName() != *ComponentName)
-				{
-					continue;
-				}
-				if (sameNumberHit == Result.ComponentIndices[i])
-				{
-					MatchingComponent = SceneComponent;
-					break;
-				}
-				++sameNumberHit;
-			}
+			return World;
 		}
-		if (sameNumberHit < Result.ComponentIndices[i])
+	}
+	// The any-package StaticFindObjectFast is deprecated, and there are only a handful of worlds to compare by FName.
+	for (TObjectIterator<UWorld> It; It; ++It)
+	{
+		if (It->GetFName() == WorldName)
 		{
-			return nullptr;
+			return *It;
 		}
 	}
-	if (MatchingComponent == nullptr)
+	return nullptr;
+}
+
+TArray<UWorld*> UWorldNavigator::FindWorldsByPattern(const FPathPatternSegment& Segment)
+{
+	TArray<UWorld*> Worlds;
+	if (Segment.Kind == FPathPatternSegment::EKind::Exact)
 	{
-		return nullptr;
+		if (const auto World = FindWorldByName(Segment.Name))
+		{
+			Worlds.Add(World);
+		}
+		return Worlds;
 	}
-	return MatchingComponent;
+	// There are only a handful of worlds, so testing each one is cheap.
+	for (TObjectIterator<UWorld> It; It; ++It)
+	{
+		if (It->PersistentLevel != nullptr and Segment.MatchesName(It->GetFName()))
+		{
+			Worlds.Add(*It);
+		}
+	}
+	return Worlds;
 }
 
-AActor* UWorldNavigator::FindUActorByPath(FString& Path)
+void UWorldNavigator::FindActorsByPattern(const FPathPattern& Pattern, FWorldPathIndex& Index, TArray<AActor*>& Result)
 {
-	if (Path.IsEmpty())
+	TArray<ULevel*> Levels;
+	Index.FindLevels(Pattern.Level, Levels);
+	for (const auto Level : Levels)
 	{
-		return nullptr;
+		Index.FindActors(Level, Pattern.Actor, Result);
 	}
-	if (Path == TEXT("[invalid world]"))
+}
+
+ULevel* UWorldNavigator::FindLevelByName(UWorld* World, FName LevelName, int32 LevelIndex)
+{
+	if (const auto Index = FWorldPathIndex::Find(World))
 	{
-		return nullptr;
+		return Index->FindLevel(LevelName, LevelIndex);
 	}
-	if (Path == TEXT("[invalid level]"))
+	int32 sameNumberHit = 0;
+	for (auto Level : GetAllLevelsInWorld(World))
+	{
+		if (Level == nullptr or Level->GetFName() != LevelName)
+		{
+			continue;
+		}
+		if (sameNumberHit == LevelIndex)
+		{
+			return Level;
+		}
+		sameNumberHit += 1;
+	}
+	return nullptr;
+}
+
+AActor* UWorldNavigator::FindActorByName(ULevel* Level, FName ActorName, int32 ActorIndex)
+{
+	if (Level == nullptr)
 	{
 		return nullptr;
 	}
-	auto ErrorMessage = FString();
-	FPathStructure Result;
-	if (!FPathStructure::TryParse(Path, ErrorMessage, Result))
+	if (const auto Index = FWorldPathIndex::Find(Level->GetWorld()))
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s"), *ErrorMessage);
+		return Index->FindActor(Level, ActorName, ActorIndex);
 	}
-	const auto World = FindObject<UWorld>(ANY_PACKAGE, *Result.WorldName);
-	if (World == nullptr)
+	int32 sameNumberHit = 0;
+	for (AActor* Actor : Level->Actors)
 	{
-		return nullptr;
+		if (Actor == nullptr or Actor->GetFName() != ActorName)
+		{
+			continue;
+		}
+		if (sameNumberHit == ActorIndex)
+		{
+			return Actor;
+		}
+		sameNumberHit += 1;
 	}
-	const auto Level = FindObject<ULevel>(World, *Result.LevelName);
-	if (Level == nullptr)
+	return nullptr;
+}
+
+UActorComponent* UWorldNavigator::FindComponentByName(AActor* Actor, FName ComponentName, int32 ComponentIndex)
+{
+	if (const auto Index = FWorldPathIndex::Find(Actor->GetWorld()))
 	{
-		return nullptr;
+		return Index->FindComponent(Actor, ComponentName, ComponentIndex);
 	}
-	const auto Actor = FindObject<AActor>(Level, *Result.ActorName);
-	if (Actor == nullptr)
+	int32 sameNumberHit = 0;
+	for (auto Component : GetAllComponentsInActor(Actor))
 	{
-		return nullptr;
+		if (Component->GetFName() != ComponentName)
+		{
+			continue;
+		}
+		if (sameNumberHit == ComponentIndex)
+		{
+			return Component;
+		}
+		++sameNumberHit;
 	}
-	return Actor;
+	return nullptr;
 }
 
-TArray<FString> UWorldNavigator::GetSceneComponentHierarchy(USceneComponent* Component)
+USceneComponent* UWorldNavigator::FindAttachChildByName(FWorldPathIndex& Index, USceneComponent* Parent,
+                                                        FName ComponentName, int32 ComponentIndex)
 {
-	TArray<FString> Result;
-	auto StartComponent = Component;
-	const auto StartComponentName = StartComponent->GetName();
-	const auto StartComponentIndex = GetIndexOfSameComponent(StartComponent);
-	Result.Add(FString::Printf(TEXT("%s[%d]"), *StartComponentName, StartComponentIndex));
-	while (true)
+	// Indices still count same-name components of the child's owner, but only children with the right name need one.
+	for (USceneComponent* Child : Parent->GetAttachChildren())
 	{
-		const auto ParentComponent = StartComponent->GetAttachParent();
-		if (ParentComponent == nullptr)
+		if (Child != nullptr and Child->GetFName() == ComponentName
+			and Index.GetComponentIndex(Child) == ComponentIndex)
 		{
-			break;
+			return Child;
 		}
-		auto ComponentName = ParentComponent->GetName();
-		const auto ComponentIndex = GetIndexOfSameComponent(ParentComponent);
+	}
+	return nullptr;
+}
+
+TArray<FString> UWorldNavigator::GetSceneComponentHierarchy(USceneComponent* Component)
+{
+	// Without a registered index, a scratch one still builds each owner's sorted component table only once.
+	TOptional<FWorldPathIndex> ScratchIndex;
+	auto Index = FWorldPathIndex::Find(Component->GetWorld());
+	if (Index == nullptr)
+	{
+		Index = &ScratchIndex.Emplace(Component->GetWorld(), false);
+	}
+	TArray<FString> Result;
+	for (auto CurrentComponent = Component; CurrentComponent != nullptr;
+	     CurrentComponent = CurrentComponent->GetAttachParent())
+	{
+		const auto ComponentName = CurrentComponent->GetName();
+		const auto ComponentIndex = Index->GetComponentIndex(CurrentComponent);
 		Result.Add(FString::Printf(TEXT("%s[%d]"), *ComponentName, ComponentIndex));
-		StartComponent = ParentComponent;
 	}
 	Algo::Reverse(Result);
 	return Result;
@@ -283,6 +641,7 @@ TArray<FString> UWorldNavigator::GetSceneComponentHierarchy(USceneComponent* Com
 
 FString UWorldNavigator::GetWorldPath(AActor* Actor)
 {
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_GeneratePath);
 	if (Actor == nullptr)
 	{
 		return TEXT("[invalid actor]");
@@ -308,6 +667,7 @@ FString UWorldNavigator::GetWorldPath(AActor* Actor)
 
 FString UWorldNavigator::GetWorldPath(UActorComponent* Component)
 {
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_GeneratePath);
 	if (Component == nullptr)
 	{
 		return TEXT("[invalid component]");
@@ -344,6 +704,7 @@ FString UWorldNavigator::GetWorldPath(UActorComponent* Component)
 
 FString UWorldNavigator::GetWorldPath(USceneComponent* Component)
 {
+	DEBUGUTILS_SCOPE(STAT_DebugUtils_GeneratePath);
 	if (Component == nullptr)
 	{
 		return TEXT("[null Component]");
@@ -376,12 +737,21 @@ FString UWorldNavigator::GetWorldPath(USceneComponent* Component)
 
 int32 UWorldNavigator::GetIndexOfSameLevel(ULevel* Level)
 {
-	auto Levels = GetAllLevelsInWorld(Level->GetWorld());
-	for (int32 i = 0; i < Levels.Num(); ++i)
+	const auto World = Level->GetWorld();
+	if (const auto Index = FWorldPathIndex::Find(World))
 	{
-		if (Levels[i] == Level)
+		return Index->GetLevelIndex(Level);
+	}
+	int32 sameNumberHit = 0;
+	for (auto OtherLevel : GetAllLevelsInWorld(World))
+	{
+		if (OtherLevel == Level)
+		{
+			return sameNumberHit;
+		}
+		if (OtherLevel != nullptr and OtherLevel->GetFName() == Level->GetFName())
 		{
-			return i;
+			++sameNumberHit;
 		}
 	}
 	return -1;
@@ -389,16 +759,26 @@ int32 UWorldNavigator::GetIndexOfSameLevel(ULevel* Level)
 
 int32 UWorldNavigator::GetIndexOfSameActor(AActor* Actor)
 {
-	auto Levels = GetAllLevelsInWorld(Actor->GetWorld());
-	for (int32 i = 0; i < Levels.Num(); ++i)
+	const auto Level = Actor->GetLevel();
+	if (Level == nullptr)
+	{
+		return -1;
+	}
+	if (const auto Index = FWorldPathIndex::Find(Level->GetWorld()))
 	{
-		auto Actors = GetAllActorsInLevel(Levels[i]);
-		for (int32 j = 0; j < Actors.Num(); ++j)
+		return Index->GetActorIndex(Actor);
+	}
+	// Only the actor's own level can hold the name, so there is no need to walk the other levels.
+	int32 sameNumberHit = 0;
+	for (AActor* OtherActor : Level->Actors)
+	{
+		if (OtherActor == Actor)
 		{
-			if (Actors[j] == Actor)
-			{
-				return i;
-			}
+			return sameNumberHit;
+		}
+		if (OtherActor != nullptr and OtherActor->GetFName() == Actor->GetFName())
+		{
+			++sameNumberHit;
 		}
 	}
 	return -1;
@@ -406,12 +786,20 @@ int32 UWorldNavigator::GetIndexOfSameActor(AActor* Actor)
 
 int32 UWorldNavigator::GetIndexOfSameComponent(UActorComponent* Component)
 {
-	auto Components = GetAllComponentsInActor(Component->GetOwner());
-	for (int32 i = 0; i < Components.Num(); ++i)
+	if (const auto Index = FWorldPathIndex::Find(Component->GetWorld()))
+	{
+		return Index->GetComponentIndex(Component);
+	}
+	int32 sameNumberHit = 0;
+	for (auto OtherComponent : GetAllComponentsInActor(Component->GetOwner()))
 	{
-		if (Components[i] == Component)
+		if (OtherComponent == Component)
 		{
-			return i;
+			return sameNumberHit;
+		}
+		if (OtherComponent->GetFName() == Component->GetFName())
+		{
+			++sameNumberHit;
 		}
 	}
 	return -1;
@@ -419,22 +807,22 @@ int32 UWorldNavigator::GetIndexOfSameComponent(UActorComponent* Component)
 
 int32 UWorldNavigator::GetIndexOfSameComponent(USceneComponent* Component)
 {
-	auto Components = GetAllComponentsInActor(Component->GetOwner());
-	for (int32 i = 0; i < Components.Num(); ++i)
-	{
-		if (Components[i] == Component)
-		{
-			return i;
-		}
-	}
-	return -1;
+	return GetIndexOfSameComponent(static_cast<UActorComponent*>(Component));
 }
 
 TArray<ULevel*> UWorldNavigator::GetAllLevelsInWorld(UWorld* World)
 {
 	TArray<ULevel*> Levels;
 	Levels.Add(World->PersistentLevel);
-	Levels.Append(World->GetLevels()); // Streaming levels
+	// GetLevels() lists the persistent level too once the world is initialized; a second entry would give it a
+	// second same-name index.
+	for (ULevel* Level : World->GetLevels()) // Streaming levels
+	{
+		if (Level != World->PersistentLevel)
+		{
+			Levels.Add(Level);
+		}
+	}
 	return Levels;
 }
 
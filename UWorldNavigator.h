@@ -1,8 +1,11 @@
 ﻿#pragma once
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "FPathStructure.h"
 #include "UWorldNavigator.generated.h"
 
+class FWorldPathIndex;
+
 UCLASS()
 class DEBUGUTILS_API UWorldNavigator : public UBlueprintFunctionLibrary
 {
@@ -17,6 +20,20 @@ public:
 	static UActorComponent* FindActorComponentByPath(FString& Path);
 	UFUNCTION(BlueprintCallable, Category = "World Navigator")
 	static USceneComponent* FindSceneComponentByPath(FString& Path);
+	//Compiled path lookups, reusable across frames without re-parsing
+	static AActor* FindUActorByPath(const FCompiledPathStructure& Path);
+	static UActorComponent* FindActorComponentByPath(const FCompiledPathStructure& Path);
+	static USceneComponent* FindSceneComponentByPath(const FCompiledPathStructure& Path);
+	//FindActorComponentsByPaths
+	UFUNCTION(BlueprintCallable, Category = "World Navigator")
+	static TArray<UActorComponent*> FindActorComponentsByPaths(const TArray<FString>& Paths);
+	//FindByPattern, e.g. "Persistent@PersistentLevel:/BP_Enemy*->**"
+	UFUNCTION(BlueprintCallable, Category = "World Navigator")
+	static TArray<AActor*> FindActorsByPattern(const FString& Pattern);
+	UFUNCTION(BlueprintCallable, Category = "World Navigator")
+	static TArray<UActorComponent*> FindComponentsByPattern(const FString& Pattern);
+	static TArray<AActor*> FindActorsByPattern(const FPathPattern& Pattern);
+	static TArray<UActorComponent*> FindComponentsByPattern(const FPathPattern& Pattern);
 	//GetWorldPath
 	UFUNCTION(BlueprintCallable, Category = "World Navigator")
 	static FString GetWorldPath(AActor* Actor);
@@ -24,9 +41,41 @@ public:
 	static FString GetWorldPath(UActorComponent* Component);
 	UFUNCTION(BlueprintCallable, Category = "World Navigator")
 	static FString GetWorldPath(USceneComponent* Component);
+	//GetAllWorldPaths
+	UFUNCTION(BlueprintCallable, Category = "World Navigator")
+	static TMap<UObject*, FString> GetAllWorldPaths(ULevel* Level);
+	//PathIndex
+	UFUNCTION(BlueprintCallable, Category = "World Navigator")
+	static void SetPathIndexEnabled(UWorld* World, bool bEnabled);
+	UFUNCTION(BlueprintCallable, Category = "World Navigator")
+	static bool IsPathIndexEnabled(UWorld* World);
+	//PersistedPathIndex
+	UFUNCTION(BlueprintCallable, Category = "World Navigator")
+	static bool SavePathIndex(UWorld* World, const FString& FilePath);
+	UFUNCTION(BlueprintCallable, Category = "World Navigator")
+	static bool LoadPathIndex(UWorld* World, const FString& FilePath);
+	//NavigationSnapshot
+	UFUNCTION(BlueprintCallable, Category = "World Navigator")
+	static void PublishNavigationSnapshot(UWorld* World);
 
 private:
+	friend class FWorldPathIndex;
+	friend class FWorldNavigationSnapshot;
+	friend class FWorldPathTable;
+	friend class FPersistedWorldPathIndex;
+
+	static AActor* FindActorByPath(const FCompiledPathStructure& Path);
+	static UWorld* FindWorldByName(FName WorldName);
+	static TArray<UWorld*> FindWorldsByPattern(const FPathPatternSegment& Segment);
+	static void FindActorsByPattern(const FPathPattern& Pattern, FWorldPathIndex& Index, TArray<AActor*>& Result);
+	static ULevel* FindLevelByName(UWorld* World, FName LevelName, int32 LevelIndex);
+	static AActor* FindActorByName(ULevel* Level, FName ActorName, int32 ActorIndex);
+	static UActorComponent* FindComponentByName(AActor* Actor, FName ComponentName, int32 ComponentIndex);
+	static USceneComponent* FindAttachChildByName(FWorldPathIndex& Index, USceneComponent* Parent, FName ComponentName,
+	                                              int32 ComponentIndex);
 	static TArray<FString> GetSceneComponentHierarchy(USceneComponent* Component);
+	static void AppendActorWorldPaths(const FString& LevelPrefix, AActor* Actor, int32 ActorIndex,
+	                                  TArray<TPair<UObject*, FString>>& Result);
 	static TArray<ULevel*> GetAllLevelsInWorld(UWorld* World);
 	static TArray<AActor*> GetAllActorsInLevel(ULevel* Level);
 	static TArray<UActorComponent*> GetAllComponentsInActor(AActor* Actor);